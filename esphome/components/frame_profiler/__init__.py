@@ -0,0 +1,32 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import display
+from esphome.const import CONF_DISPLAY_ID, CONF_ID
+
+DEPENDENCIES = ["display"]
+
+frame_profiler_ns = cg.esphome_ns.namespace("frame_profiler")
+FrameProfiler = frame_profiler_ns.class_("FrameProfiler", cg.PollingComponent)
+
+CONF_FRAMES = "frames"
+CONF_FRAME_PROFILER_ID = "frame_profiler_id"
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(FrameProfiler),
+        cv.Optional(CONF_DISPLAY_ID): cv.use_id(display.Display),
+        cv.Optional(CONF_FRAMES, default=60): cv.int_range(min=4, max=240),
+    }
+).extend(cv.polling_component_schema("10s"))
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID], config[CONF_FRAMES])
+    await cg.register_component(var, config)
+
+    if CONF_DISPLAY_ID in config:
+        disp = await cg.get_variable(config[CONF_DISPLAY_ID])
+        cg.add(var.set_display(disp))
+
+    # Enables the measuring points in gfx_blend
+    cg.add_define("USE_FRAME_PROFILER")
@@ -0,0 +1,228 @@
+/**
+ * Frame Profiler
+ *
+ * @brief Measures where the time of a display frame goes (scene lambda, blend pipeline,
+ * framebuffer writes, flush to the panel). Keeps the last N frames in a ring buffer and
+ * exposes min/avg/p95/max per phase as sensors and as JSON.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#include "frame_profiler.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include <algorithm>
+#include <utility>
+
+namespace esphome {
+namespace frame_profiler {
+
+static const char *const TAG = "frame_profiler";
+
+static const char *const PHASE_NAMES[PHASE_COUNT] = {"scene", "blend", "write", "flush", "total"};
+
+FrameProfiler *global_frame_profiler = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * Helper class to access the lambda writer of esphome::display::Display.
+ */
+class DisplayWriterAccessor : public display::Display {
+ public:
+  static optional<display::display_writer_t> &get_writer(display::Display *display) {
+    return static_cast<DisplayWriterAccessor *>(display)->writer_;
+  }
+};
+
+uint32_t PhaseStats::get(Statistic statistic) const {
+  switch (statistic) {
+    case Statistic::LAST:
+      return this->last;
+    case Statistic::MIN:
+      return this->min;
+    case Statistic::P95:
+      return this->p95;
+    case Statistic::MAX:
+      return this->max;
+    case Statistic::AVG:
+    default:
+      return this->avg;
+  }
+}
+
+void FrameProfiler::setup() {
+  this->ring_.resize(this->frames_);
+  global_frame_profiler = this;
+
+  if (this->display_ != nullptr)
+    this->hook_display_();
+}
+
+/**
+ * Wraps the display lambda with begin_frame()/end_scene().
+ * The flush to the panel runs after the lambda inside the display's update(); it is measured up
+ * to the next loop(), so it is an upper bound that includes scheduler work of the same iteration.
+ */
+void FrameProfiler::hook_display_() {
+  auto &writer = DisplayWriterAccessor::get_writer(this->display_);
+  if (!writer.has_value()) {
+    ESP_LOGW(TAG, "Display has no lambda, frames must be marked with begin_frame()/end_scene()");
+    return;
+  }
+
+  display::display_writer_t scene = std::move(*writer);
+  this->display_->set_writer([this, scene](display::Display &it) {
+    this->begin_frame();
+    scene(it);
+    this->end_scene();
+  });
+}
+
+void FrameProfiler::loop() {
+  if (this->pending_)
+    this->end_frame();
+}
+
+void FrameProfiler::begin_frame() {
+  for (auto &phase : this->current_)
+    phase.store(0, std::memory_order_relaxed);
+
+  this->frame_start_ = micros();
+  this->in_frame_ = true;
+  this->pending_ = false;
+}
+
+void FrameProfiler::end_scene() {
+  if (!this->in_frame_)
+    return;
+
+  this->scene_end_ = micros();
+  this->add(Phase::SCENE, this->scene_end_ - this->frame_start_);
+  this->pending_ = true;
+}
+
+void FrameProfiler::end_frame() {
+  if (!this->in_frame_ || this->ring_.empty())
+    return;
+
+  const uint32_t now = micros();
+  if (!this->pending_)
+    this->end_scene();
+  this->add(Phase::FLUSH, now - this->scene_end_);
+
+  Frame frame;
+  frame.start = this->frame_start_;
+  for (size_t i = 0; i < PHASE_COUNT; i++)
+    frame.us[i] = this->current_[i].exchange(0, std::memory_order_relaxed);
+  frame.us[static_cast<size_t>(Phase::TOTAL)] =
+      frame.us[static_cast<size_t>(Phase::SCENE)] + frame.us[static_cast<size_t>(Phase::FLUSH)];
+
+  {
+    LockGuard guard(this->lock_);
+    this->ring_[this->head_] = frame;
+    this->head_ = (this->head_ + 1) % this->ring_.size();
+    if (this->count_ < this->ring_.size())
+      this->count_++;
+  }
+
+  this->in_frame_ = false;
+  this->pending_ = false;
+}
+
+std::vector<FrameProfiler::Frame> FrameProfiler::copy_frames_() {
+  LockGuard guard(this->lock_);
+  std::vector<Frame> frames;
+  frames.reserve(this->count_);
+  const size_t size = this->ring_.size();
+  for (size_t i = 0; i < this->count_; i++)
+    frames.push_back(this->ring_[(this->head_ + 2 * size - 1 - i) % size]);
+  return frames;
+}
+
+PhaseStats FrameProfiler::compute_stats_(const std::vector<Frame> &frames, Phase phase) {
+  PhaseStats stats;
+  if (frames.empty())
+    return stats;
+
+  const size_t index = static_cast<size_t>(phase);
+  std::vector<uint32_t> values;  // Sorting buffer for the percentile
+  values.reserve(frames.size());
+  uint64_t sum = 0;
+  stats.min = UINT32_MAX;
+  for (const Frame &frame : frames) {
+    const uint32_t us = frame.us[index];
+    values.push_back(us);
+    sum += us;
+    stats.min = std::min(stats.min, us);
+    stats.max = std::max(stats.max, us);
+  }
+  stats.last = frames.front().us[index];
+  stats.avg = uint32_t(sum / frames.size());
+
+  // Nearest-rank percentile
+  const size_t rank = (frames.size() * 95 + 99) / 100 - 1;
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  stats.p95 = values[rank];
+
+  return stats;
+}
+
+float FrameProfiler::compute_fps_(const std::vector<Frame> &frames) {
+  if (frames.size() < 2)
+    return 0.0f;
+
+  const uint32_t span = frames.front().start - frames.back().start;
+  return span == 0 ? 0.0f : (frames.size() - 1) * 1e6f / span;
+}
+
+PhaseStats FrameProfiler::get_stats(Phase phase) { return compute_stats_(this->copy_frames_(), phase); }
+
+float FrameProfiler::get_fps() { return compute_fps_(this->copy_frames_()); }
+
+size_t FrameProfiler::get_frame_count() {
+  LockGuard guard(this->lock_);
+  return this->count_;
+}
+
+std::string FrameProfiler::to_json() {
+  // One copy for all phases, so the numbers belong to the same frames
+  const std::vector<Frame> frames = this->copy_frames_();
+  std::string json =
+      str_sprintf("{\"frames\":%u,\"fps\":%.1f,\"phases\":{", (unsigned) frames.size(), compute_fps_(frames));
+
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    const PhaseStats stats = compute_stats_(frames, static_cast<Phase>(i));
+    json += str_sprintf("%s\"%s\":{\"last\":%u,\"min\":%u,\"avg\":%u,\"p95\":%u,\"max\":%u}", i > 0 ? "," : "",
+                        PHASE_NAMES[i], (unsigned) stats.last, (unsigned) stats.min, (unsigned) stats.avg,
+                        (unsigned) stats.p95, (unsigned) stats.max);
+  }
+
+  json += "}}";
+  return json;
+}
+
+void FrameProfiler::update() {
+#ifdef USE_SENSOR
+  const std::vector<Frame> frames = this->copy_frames_();
+  if (frames.empty())
+    return;
+
+  for (auto &entry : this->sensors_) {
+    entry.sensor->publish_state(compute_stats_(frames, entry.phase).get(entry.statistic));
+  }
+#endif
+}
+
+void FrameProfiler::dump_config() {
+  ESP_LOGCONFIG(TAG, "Frame Profiler:");
+  ESP_LOGCONFIG(TAG, "  Frames: %u", this->frames_);
+  ESP_LOGCONFIG(TAG, "  Display hook: %s", this->display_ != nullptr ? "yes" : "no");
+#ifdef USE_SENSOR
+  ESP_LOGCONFIG(TAG, "  Sensors: %u", (unsigned) this->sensors_.size());
+#endif
+  LOG_UPDATE_INTERVAL(this);
+}
+
+}  // namespace frame_profiler
+}  // namespace esphome
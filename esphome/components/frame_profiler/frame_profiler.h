@@ -0,0 +1,164 @@
+/**
+ * Frame Profiler
+ *
+ * @brief Measures where the time of a display frame goes (scene lambda, blend pipeline,
+ * framebuffer writes, flush to the panel). Keeps the last N frames in a ring buffer and
+ * exposes min/avg/p95/max per phase as sensors and as JSON.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/display/display.h"
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace frame_profiler {
+
+/**
+ * Phases of a frame.
+ * SCENE is the wall time of the display lambda and includes BLEND and WRITE;
+ * TOTAL is SCENE + FLUSH.
+ */
+enum class Phase : uint8_t {
+  SCENE = 0,  // Display lambda (begin_frame() .. end_scene())
+  BLEND,      // Effect pipeline and blur/shadow/layer kernels (gfx_blend)
+  WRITE,      // Framebuffer transfers (gfx_blend)
+  FLUSH,      // end_scene() .. end_frame(), i.e. the transfer to the panel
+  TOTAL,
+};
+static constexpr size_t PHASE_COUNT = 5;
+
+enum class Statistic : uint8_t { LAST = 0, MIN, AVG, P95, MAX };
+
+struct PhaseStats {
+  uint32_t last{0};
+  uint32_t min{0};
+  uint32_t avg{0};
+  uint32_t p95{0};
+  uint32_t max{0};
+
+  uint32_t get(Statistic statistic) const;
+};
+
+class FrameProfiler : public PollingComponent {
+ public:
+  explicit FrameProfiler(uint16_t frames) : frames_(frames) {}
+
+  void setup() override;
+  void loop() override;
+  void update() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::PROCESSOR; }
+
+  void set_display(display::Display *display) { this->display_ = display; }
+#ifdef USE_SENSOR
+  void add_sensor(Phase phase, Statistic statistic, sensor::Sensor *sensor) {
+    this->sensors_.push_back({phase, statistic, sensor});
+  }
+#endif
+
+  /**
+   * Frame boundaries. With `display_id` they are set by a wrapper around the display lambda;
+   * without it they can be called manually. end_frame() is optional: a pending frame is
+   * completed by the next loop().
+   */
+  void begin_frame();
+  void end_scene();
+  void end_frame();
+
+  /**
+   * Adds time to a phase of the current frame.
+   * Safe to call from any task (e.g. render_parallel() workers, whose times add up).
+   */
+  void add(Phase phase, uint32_t us) {
+    this->current_[static_cast<size_t>(phase)].fetch_add(us, std::memory_order_relaxed);
+  }
+
+  /**
+   * Statistics are computed from a copy of the ring buffer taken under a lock, so they can be
+   * read from other tasks (e.g. a web server route) while the main loop records frames.
+   */
+  PhaseStats get_stats(Phase phase);
+  float get_fps();
+  size_t get_frame_count();
+
+  // Statistics of all phases, e.g. {"frames":60,"fps":24.8,"phases":{"scene":{"last":..,"min":..,...},...}}
+  std::string to_json();
+
+ protected:
+  struct Frame {
+    uint32_t start;                         // micros() at begin_frame()
+    std::array<uint32_t, PHASE_COUNT> us;  // Microseconds per phase
+  };
+
+#ifdef USE_SENSOR
+  struct SensorEntry {
+    Phase phase;
+    Statistic statistic;
+    sensor::Sensor *sensor;
+  };
+  std::vector<SensorEntry> sensors_;
+#endif
+
+  void hook_display_();
+  std::vector<Frame> copy_frames_();  // Recorded frames, newest first
+  static PhaseStats compute_stats_(const std::vector<Frame> &frames, Phase phase);
+  static float compute_fps_(const std::vector<Frame> &frames);
+
+  uint16_t frames_;
+  Mutex lock_;               // Guards ring_, head_ and count_
+  std::vector<Frame> ring_;  // Last `frames_` frames, oldest at head_ once full
+  size_t head_{0};
+  size_t count_{0};
+
+  std::array<std::atomic<uint32_t>, PHASE_COUNT> current_{};
+  uint32_t frame_start_{0};
+  uint32_t scene_end_{0};
+  bool in_frame_{false};
+  bool pending_{false};  // Scene finished, waiting for end_frame()
+
+  display::Display *display_{nullptr};
+};
+
+extern FrameProfiler *global_frame_profiler;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * Adds the lifetime of the scope to a phase of the global profiler.
+ * Costs two micros() calls, so it is placed around spans and blocks, never single pixels.
+ */
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(Phase phase) : phase_(phase), start_(micros()) {}
+  ~PhaseTimer() {
+    if (global_frame_profiler != nullptr)
+      global_frame_profiler->add(this->phase_, micros() - this->start_);
+  }
+
+  PhaseTimer(const PhaseTimer &) = delete;
+  PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+ protected:
+  Phase phase_;
+  uint32_t start_;
+};
+
+}  // namespace frame_profiler
+}  // namespace esphome
+
+// Measuring point for other components (they define it as a no-op without USE_FRAME_PROFILER)
+#define FRAME_PROFILER_SCOPE(phase) \
+  ::esphome::frame_profiler::PhaseTimer frame_profiler_scope_(::esphome::frame_profiler::Phase::phase)
@@ -0,0 +1,49 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import STATE_CLASS_MEASUREMENT
+
+from . import CONF_FRAME_PROFILER_ID, FrameProfiler, frame_profiler_ns
+
+DEPENDENCIES = ["frame_profiler"]
+
+CONF_PHASE = "phase"
+CONF_STATISTIC = "statistic"
+UNIT_MICROSECOND = "µs"
+
+Phase = frame_profiler_ns.enum("Phase", is_class=True)
+PHASES = {
+    "scene": Phase.SCENE,
+    "blend": Phase.BLEND,
+    "write": Phase.WRITE,
+    "flush": Phase.FLUSH,
+    "total": Phase.TOTAL,
+}
+
+Statistic = frame_profiler_ns.enum("Statistic", is_class=True)
+STATISTICS = {
+    "last": Statistic.LAST,
+    "min": Statistic.MIN,
+    "avg": Statistic.AVG,
+    "p95": Statistic.P95,
+    "max": Statistic.MAX,
+}
+
+CONFIG_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MICROSECOND,
+    icon="mdi:timer-outline",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+).extend(
+    {
+        cv.GenerateID(CONF_FRAME_PROFILER_ID): cv.use_id(FrameProfiler),
+        cv.Required(CONF_PHASE): cv.enum(PHASES, lower=True),
+        cv.Optional(CONF_STATISTIC, default="avg"): cv.enum(STATISTICS, lower=True),
+    }
+)
+
+
+async def to_code(config):
+    parent = await cg.get_variable(config[CONF_FRAME_PROFILER_ID])
+    sens = await sensor.new_sensor(config)
+    cg.add(parent.add_sensor(config[CONF_PHASE], config[CONF_STATISTIC], sens))
@@ -7,7 +7,7 @@
  * 
  * @author fschroedter
  * @copyright MIT License
- * @note This library requires a 16-bit color display (RGB565).
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
  */
 
 
@@ -0,0 +1,271 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "defs.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * Separable blend modes (W3C Compositing Level 1) on RGB565 colors.
+ *
+ * Every mode is an `Op` with
+ * - `channel<M>(s, b)`: per-channel formula in native precision (M = 31 or 63), s = source (fg), b = backdrop (bg)
+ * - `pair(fg2, bg2)` (optional): two pixels packed into one 32-bit word (first pixel in the low half)
+ *
+ * BlendMode<Op> turns an Op into a pipeline effect with a per-pixel operator() and a span() form
+ * that processes two pixels per iteration.
+ */
+namespace blend_ops {
+
+// Per-channel division by M = 2^k - 1 with rounding, without a division instruction
+template <uint32_t M>
+static inline uint32_t div_max(uint32_t v)
+{
+  constexpr uint32_t k = (M == 63) ? 6 : 5;
+  v += (M + 1) >> 1;
+  return (v + (v >> k)) >> k;
+}
+
+// Q16 reciprocals 65536 / d for d = 1..63 (index 0 unused), used by dodge and burn
+struct RecipTable {
+  uint32_t v[64];
+  constexpr RecipTable() : v{}
+  {
+    for (uint32_t i = 1; i < 64; i++) v[i] = (65536 + i / 2) / i;
+  }
+};
+static constexpr RecipTable RECIP{};
+
+// round(sqrt(v / 63) * 63) for v = 0..63, used by soft light
+struct SqrtTable {
+  uint8_t v[64];
+  constexpr SqrtTable() : v{}
+  {
+    for (uint32_t i = 0; i < 64; i++) {
+      uint32_t r = 0;
+      while ((r + 1) * (r + 1) <= 63 * i) r++;
+      v[i] = uint8_t(r * r + r < 63 * i ? r + 1 : r);
+    }
+  }
+};
+static constexpr SqrtTable SQRT63{};
+
+/**
+ * SWAR helpers for two packed RGB565 pixels.
+ * Channel fields of both pixels are processed together. Red is shifted down by one bit so that
+ * every field has a free guard bit above it.
+ */
+struct Packed {
+  static constexpr uint32_t R = 0x7C007C00;  // Red (after >> 1), bits 10-14 and 26-30
+  static constexpr uint32_t G = 0x07E007E0;  // Green, bits 5-10 and 21-26
+  static constexpr uint32_t B = 0x001F001F;  // Blue, bits 0-4 and 16-20
+
+  // Field masks (all ones) where a >= b, computed with one subtraction for all fields
+  template <uint32_t FIELD, uint32_t WIDTH>
+  static inline uint32_t ge_fields(uint32_t a, uint32_t b)
+  {
+    constexpr uint32_t LSB = FIELD & ~(FIELD << 1);  // Lowest bit of every field
+    constexpr uint32_t TOP = LSB << WIDTH;           // Guard bit above every field
+    uint32_t g = ((a | TOP) - b) & TOP;              // Guard survives where a >= b
+    return g - (g >> WIDTH);                         // Expand guard bits into field masks
+  }
+
+  template <uint32_t FIELD, uint32_t WIDTH>
+  static inline uint32_t min_fields(uint32_t a, uint32_t b)
+  {
+    uint32_t m = ge_fields<FIELD, WIDTH>(a, b);
+    return (b & m) | (a & ~m & FIELD);
+  }
+
+  template <uint32_t FIELD, uint32_t WIDTH>
+  static inline uint32_t max_fields(uint32_t a, uint32_t b)
+  {
+    uint32_t m = ge_fields<FIELD, WIDTH>(a, b);
+    return (a & m) | (b & ~m & FIELD);
+  }
+};
+
+struct Multiply {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    return div_max<M>(s * b);
+  }
+};
+
+struct Screen {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    return s + b - div_max<M>(s * b);
+  }
+};
+
+// Overlay = hard light with source and backdrop swapped: the backdrop selects multiply or screen
+struct Overlay {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    if (2 * b <= M) return div_max<M>(2 * s * b);
+    return M - div_max<M>(2 * (M - s) * (M - b));
+  }
+};
+
+struct Darken {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    return s < b ? s : b;
+  }
+
+  static inline uint32_t pair(uint32_t s, uint32_t b)
+  {
+    uint32_t r = Packed::min_fields<Packed::R, 5>((s >> 1) & Packed::R, (b >> 1) & Packed::R) << 1;
+    uint32_t g = Packed::min_fields<Packed::G, 6>(s & Packed::G, b & Packed::G);
+    uint32_t bl = Packed::min_fields<Packed::B, 5>(s & Packed::B, b & Packed::B);
+    return r | g | bl;
+  }
+};
+
+struct Lighten {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    return s > b ? s : b;
+  }
+
+  static inline uint32_t pair(uint32_t s, uint32_t b)
+  {
+    uint32_t r = Packed::max_fields<Packed::R, 5>((s >> 1) & Packed::R, (b >> 1) & Packed::R) << 1;
+    uint32_t g = Packed::max_fields<Packed::G, 6>(s & Packed::G, b & Packed::G);
+    uint32_t bl = Packed::max_fields<Packed::B, 5>(s & Packed::B, b & Packed::B);
+    return r | g | bl;
+  }
+};
+
+struct Difference {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    return s > b ? s - b : b - s;
+  }
+
+  // |a - b| = max - min per field; never borrows across fields
+  template <uint32_t FIELD, uint32_t WIDTH>
+  static inline uint32_t diff_fields_(uint32_t a, uint32_t b)
+  {
+    return Packed::max_fields<FIELD, WIDTH>(a, b) - Packed::min_fields<FIELD, WIDTH>(a, b);
+  }
+
+  static inline uint32_t pair(uint32_t s, uint32_t b)
+  {
+    uint32_t r = diff_fields_<Packed::R, 5>((s >> 1) & Packed::R, (b >> 1) & Packed::R) << 1;
+    uint32_t g = diff_fields_<Packed::G, 6>(s & Packed::G, b & Packed::G);
+    uint32_t bl = diff_fields_<Packed::B, 5>(s & Packed::B, b & Packed::B);
+    return r | g | bl;
+  }
+};
+
+// W3C soft light; the square root branch uses a 64 entry table
+struct SoftLight {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    if (2 * s <= M) {
+      // b - (1 - 2s) * b * (1 - b)
+      return b - div_max<M>(div_max<M>((M - 2 * s) * b) * (M - b));
+    }
+
+    // b + (2s - 1) * (D(b) - b)
+    uint32_t d;
+    if (4 * b <= M) {
+      // ((16b - 12) * b + 4) * b, evaluated in units of M
+      int32_t bi = b;
+      int32_t t = (16 * bi - 12 * (int32_t) M) * bi / (int32_t) M + 4 * (int32_t) M;
+      d = (uint32_t) (t * bi / (int32_t) M);
+    } else {
+      d = (M == 63) ? SQRT63.v[b] : (SQRT63.v[b << 1 | b >> 4] >> 1);
+    }
+    if (d < b) d = b;  // Rounding must not flip the sign of (d - b)
+    return b + div_max<M>((2 * s - M) * (d - b));
+  }
+};
+
+struct ColorDodge {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    if (b == 0) return 0;
+    if (s >= M) return M;
+    uint32_t v = (b * M * RECIP.v[M - s] + 0x8000) >> 16;
+    return v > M ? M : v;
+  }
+};
+
+struct ColorBurn {
+  template <uint32_t M>
+  static inline uint32_t channel(uint32_t s, uint32_t b)
+  {
+    if (b >= M) return M;
+    if (s == 0) return 0;
+    uint32_t v = ((M - b) * M * RECIP.v[s] + 0x8000) >> 16;
+    return v > M ? 0 : M - v;
+  }
+};
+
+}  // namespace blend_ops
+
+/**
+ * Pipeline effect for a separable blend mode.
+ * @tparam Op One of the blend_ops structs.
+ */
+template <typename Op>
+struct BlendMode {
+  static inline uint16_t HOT pixel(uint16_t fg, uint16_t bg)
+  {
+    uint32_t r = Op::template channel<31>(fg >> 11, bg >> 11);
+    uint32_t g = Op::template channel<63>((fg >> 5) & 0x3F, (bg >> 5) & 0x3F);
+    uint32_t b = Op::template channel<31>(fg & 0x1F, bg & 0x1F);
+    return uint16_t((r << 11) | (g << 5) | b);
+  }
+
+  // Two pixels packed into one word (first pixel in the low half)
+  static inline uint32_t HOT pair(uint32_t fg2, uint32_t bg2)
+  {
+    if constexpr (requires { Op::pair(fg2, bg2); }) {
+      return Op::pair(fg2, bg2);
+    } else {
+      return uint32_t(pixel(fg2 & 0xFFFF, bg2 & 0xFFFF)) | (uint32_t(pixel(fg2 >> 16, bg2 >> 16)) << 16);
+    }
+  }
+
+  inline uint16_t HOT operator()(int16_t x, int16_t y, uint16_t fg, uint16_t bg) const { return pixel(fg, bg); }
+
+  inline void HOT span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n) const
+  {
+    int i = 0;
+    for (; i + 1 < n; i += 2) {
+      uint32_t res = pair(fg[i] | (uint32_t(fg[i + 1]) << 16), bg[i] | (uint32_t(bg[i + 1]) << 16));
+      fg[i] = uint16_t(res);
+      fg[i + 1] = uint16_t(res >> 16);
+    }
+    if (i < n) fg[i] = pixel(fg[i], bg[i]);
+  }
+};
+
+}  // namespace gfx_blend
+}  // namespace esphome
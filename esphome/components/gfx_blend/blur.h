@@ -0,0 +1,166 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+#include "esphome/core/color.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "defs.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * Separable box blur working on single lines of RGB565 pixels or 8-bit alpha values.
+ *
+ * Three successive box passes of the same radius approximate a Gaussian with sigma ≈ radius.
+ * Every pass uses a sliding window sum, so the cost per pixel is constant regardless of the radius.
+ * Only two line buffers are needed; a 2D blur is done by blurring all rows and then all columns.
+ */
+class BoxBlur {
+public:
+  static constexpr uint8_t PASSES = 3;
+
+  explicit BoxBlur(uint8_t radius) : radius_(radius) {}
+
+  uint8_t get_radius() const { return this->radius_; }
+
+  /**
+   * Blurs `n` pixels in place. The window is clamped at both ends of the line.
+   * @param line Pixel line (RGB565), gathered by the caller from a row or a column.
+   * @param n Number of pixels in the line.
+   */
+  void blur_line(uint16_t* line, int n) { this->blur_line_(line, n, this->scratch_); }
+
+  /**
+   * Blurs `n` alpha values (0-255) in place, e.g. a coverage mask.
+   */
+  void blur_line(uint8_t* line, int n) { this->blur_line_(line, n, this->scratch_alpha_); }
+
+protected:
+  uint8_t radius_;
+  std::vector<uint16_t> scratch_;       // Ping-pong buffer, grows to the longest line seen
+  std::vector<uint8_t> scratch_alpha_;  // Ping-pong buffer for alpha lines
+
+  template <typename P>
+  void blur_line_(P* line, int n, std::vector<P>& scratch)
+  {
+    if (this->radius_ == 0 || n < 2) return;
+    if (scratch.size() < static_cast<size_t>(n)) scratch.resize(n);
+
+    P* a = line;
+    P* b = scratch.data();
+    for (uint8_t pass = 0; pass < PASSES; pass++) {
+      box_pass_(a, b, n, this->radius_);
+      std::swap(a, b);
+    }
+
+    // An odd number of passes leaves the result in the scratch buffer
+    if (a != line) std::copy(a, a + n, line);
+  }
+
+  /**
+   * One box pass with a sliding window sum per channel (O(1) per pixel).
+   * Division by the window size is replaced by a 16-bit fixed-point reciprocal.
+   */
+  static inline void HOT box_pass_(const uint16_t* src, uint16_t* dst, int n, int r)
+  {
+    const uint32_t size = 2 * r + 1;
+    const uint32_t inv = ((1u << 16) + size / 2) / size;
+    const int last = n - 1;
+
+    // Prime the window for the first output pixel: [-r, r] with clamped indices
+    uint32_t sr = 0, sg = 0, sb = 0;
+    for (int i = -r; i <= r; i++) {
+      uint16_t c = src[i < 0 ? 0 : (i > last ? last : i)];
+      sr += c >> 11;
+      sg += (c >> 5) & 0x3F;
+      sb += c & 0x1F;
+    }
+
+    for (int i = 0; i < n; i++) {
+      uint32_t r5 = (sr * inv + 0x8000) >> 16;
+      uint32_t g6 = (sg * inv + 0x8000) >> 16;
+      uint32_t b5 = (sb * inv + 0x8000) >> 16;
+      dst[i] = uint16_t((r5 << 11) | (g6 << 5) | b5);
+
+      // Slide the window: add the entering pixel, remove the leaving one (unsigned wrap is intended)
+      int in = i + r + 1;
+      int out = i - r;
+      uint16_t add = src[in > last ? last : in];
+      uint16_t sub = src[out < 0 ? 0 : out];
+      sr += (add >> 11) - (sub >> 11);
+      sg += ((add >> 5) & 0x3F) - ((sub >> 5) & 0x3F);
+      sb += (add & 0x1F) - (sub & 0x1F);
+    }
+  }
+
+  /**
+   * Single channel variant of box_pass_() for 8-bit alpha lines.
+   */
+  static inline void HOT box_pass_(const uint8_t* src, uint8_t* dst, int n, int r)
+  {
+    const uint32_t size = 2 * r + 1;
+    const uint32_t inv = ((1u << 16) + size / 2) / size;
+    const int last = n - 1;
+
+    uint32_t sum = 0;
+    for (int i = -r; i <= r; i++) sum += src[i < 0 ? 0 : (i > last ? last : i)];
+
+    for (int i = 0; i < n; i++) {
+      uint32_t a = (sum * inv + 0x8000) >> 16;
+      dst[i] = uint8_t(a > 255 ? 255 : a);  // Rounding may exceed 255 for large windows
+
+      int in = i + r + 1;
+      int out = i - r;
+      sum += src[in > last ? last : in] - src[out < 0 ? 0 : out];
+    }
+  }
+};
+
+/**
+ * Pipeline source that replaces the incoming color with a blurred copy of the background.
+ * Created by GfxBlend::blurred_bg(); the blurred region is computed once at creation and
+ * shared between copies, so the effect can be stored in a blender_t.
+ * Pixels outside the captured region keep their incoming color.
+ *
+ * Usage (frosted glass panel):
+ * gfx.with(gfx.blurred_bg(10, 10, 150, 80, 6), GfxEffects::alpha(220), [&]() {
+ *   gfx.filled_rectangle(10, 10, 150, 80, 12, Color(255, 255, 255));
+ * });
+ */
+struct BlurredBackground {
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+  std::shared_ptr<std::vector<uint16_t>> pixels;  // w * h blurred pixels, row-major
+
+  inline uint16_t HOT operator()(int16_t px, int16_t py, uint16_t fg, uint16_t bg) const
+  {
+    int16_t rx = px - this->x;
+    int16_t ry = py - this->y;
+
+    if (rx < 0 || rx >= this->w || ry < 0 || ry >= this->h || !this->pixels) {
+      return fg;
+    }
+    return (*this->pixels)[ry * this->w + rx];
+  }
+};
+
+}  // namespace gfx_blend
+}  // namespace esphome
@@ -0,0 +1,194 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "defs.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * 3x4 color matrix in 8.8 fixed point, applied to 8-bit channels:
+ *   [r' g' b']^T = M * [r g b 1]^T
+ * The fourth column is an offset in 8-bit channel units (also 8.8 fixed point).
+ *
+ * Adjustments are composed once at construction time, so any chain of them costs
+ * the same as a single matrix per pixel:
+ *   ColorMatrix::contrast(1.2f).then(ColorMatrix::saturation(0.5f)).then(ColorMatrix::hue_rotate(30))
+ */
+class ColorMatrix {
+public:
+  static constexpr int32_t ONE = 256;  // 1.0 in 8.8 fixed point
+
+  int32_t m[3][4];
+
+  // Identity matrix
+  constexpr ColorMatrix() : m{{ONE, 0, 0, 0}, {0, ONE, 0, 0}, {0, 0, ONE, 0}} {}
+
+  // Raw fixed-point matrix (8.8, offsets in 8-bit channel units * 256)
+  explicit ColorMatrix(const int32_t (&fixed)[3][4])
+  {
+    for (int row = 0; row < 3; row++)
+      for (int col = 0; col < 4; col++) this->m[row][col] = fixed[row][col];
+  }
+
+  /**
+   * Composes two matrices: the result applies `this` first and `next` afterwards.
+   */
+  ColorMatrix then(const ColorMatrix& next) const
+  {
+    ColorMatrix res;
+    for (int row = 0; row < 3; row++) {
+      for (int col = 0; col < 4; col++) {
+        int32_t sum = (col == 3) ? next.m[row][3] * ONE : 0;
+        for (int k = 0; k < 3; k++) sum += next.m[row][k] * this->m[k][col];
+        res.m[row][col] = (sum + ONE / 2) >> 8;
+      }
+    }
+    return res;
+  }
+
+  // Multiplies all channels by `factor` (1.0 = unchanged)
+  static ColorMatrix brightness(float factor)
+  {
+    const float f[3][4] = {{factor, 0, 0, 0}, {0, factor, 0, 0}, {0, 0, factor, 0}};
+    return from_float_(f);
+  }
+
+  // Scales the distance to mid gray (1.0 = unchanged, 0.0 = flat gray)
+  static ColorMatrix contrast(float factor)
+  {
+    const float o = 128.0f * (1.0f - factor);
+    const float f[3][4] = {{factor, 0, 0, o}, {0, factor, 0, o}, {0, 0, factor, o}};
+    return from_float_(f);
+  }
+
+  // Interpolates between luminance (0.0) and the original color (1.0); values > 1 oversaturate
+  static ColorMatrix saturation(float s)
+  {
+    // ITU-R BT.709 luminance weights (as used by Effects::grayscale)
+    const float lr = 0.2126f, lg = 0.7152f, lb = 0.0722f;
+    const float i = 1.0f - s;
+    const float f[3][4] = {
+        {lr * i + s, lg * i, lb * i, 0},
+        {lr * i, lg * i + s, lb * i, 0},
+        {lr * i, lg * i, lb * i + s, 0},
+    };
+    return from_float_(f);
+  }
+
+  // Rotates the hue by `degrees` while keeping luminance (W3C feColorMatrix hueRotate)
+  static ColorMatrix hue_rotate(float degrees)
+  {
+    const float rad = degrees * 3.14159265f / 180.0f;
+    const float c = cosf(rad), s = sinf(rad);
+    const float f[3][4] = {
+        {0.213f + c * 0.787f - s * 0.213f, 0.715f - c * 0.715f - s * 0.715f, 0.072f - c * 0.072f + s * 0.928f, 0},
+        {0.213f - c * 0.213f + s * 0.143f, 0.715f + c * 0.285f + s * 0.140f, 0.072f - c * 0.072f - s * 0.283f, 0},
+        {0.213f - c * 0.213f - s * 0.787f, 0.715f - c * 0.715f + s * 0.715f, 0.072f + c * 0.928f + s * 0.072f, 0},
+    };
+    return from_float_(f);
+  }
+
+  // Sepia tone; `amount` blends between the original (0.0) and full sepia (1.0)
+  static ColorMatrix sepia(float amount = 1.0f)
+  {
+    const float a = 1.0f - amount;
+    const float f[3][4] = {
+        {0.393f + 0.607f * a, 0.769f - 0.769f * a, 0.189f - 0.189f * a, 0},
+        {0.349f - 0.349f * a, 0.686f + 0.314f * a, 0.168f - 0.168f * a, 0},
+        {0.272f - 0.272f * a, 0.534f - 0.534f * a, 0.131f + 0.869f * a, 0},
+    };
+    return from_float_(f);
+  }
+
+protected:
+  static ColorMatrix from_float_(const float (&f)[3][4])
+  {
+    ColorMatrix res;
+    for (int row = 0; row < 3; row++)
+      for (int col = 0; col < 4; col++) res.m[row][col] = (int32_t) lroundf(f[row][col] * ONE);
+    return res;
+  }
+};
+
+/**
+ * Pipeline effect evaluating a ColorMatrix on the foreground color.
+ *
+ * The matrix is expanded into per-channel product tables (32 + 64 + 32 entries with the
+ * contribution to all three output channels), so a pixel costs nine table loads and no
+ * multiplications. The tables (1.5 KB) are shared between copies of the effect.
+ */
+struct ColorMatrixEffect {
+  static constexpr bool unary = true;  // Depends on fg only (can be baked into a LUT)
+
+  struct Tables {
+    int32_t r[32][3];  // Includes the offset column and the rounding term
+    int32_t g[64][3];
+    int32_t b[32][3];
+  };
+
+  std::shared_ptr<const Tables> lut;
+
+  explicit ColorMatrixEffect(const ColorMatrix& cm) : lut(build_(cm)) {}
+
+  inline uint16_t HOT apply(uint16_t c) const
+  {
+    const int32_t* tr = this->lut->r[c >> 11];
+    const int32_t* tg = this->lut->g[(c >> 5) & 0x3F];
+    const int32_t* tb = this->lut->b[c & 0x1F];
+
+    uint32_t r = clamp8_((tr[0] + tg[0] + tb[0]) >> 8);
+    uint32_t g = clamp8_((tr[1] + tg[1] + tb[1]) >> 8);
+    uint32_t b = clamp8_((tr[2] + tg[2] + tb[2]) >> 8);
+
+    return uint16_t(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+  }
+
+  inline uint16_t HOT operator()(int16_t x, int16_t y, uint16_t fg, uint16_t bg) const { return this->apply(fg); }
+
+  // Span form: one call per run of pixels instead of one per pixel
+  inline void HOT span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n) const
+  {
+    for (int i = 0; i < n; i++) fg[i] = this->apply(fg[i]);
+  }
+
+protected:
+  static inline uint32_t clamp8_(int32_t v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+  static std::shared_ptr<const Tables> build_(const ColorMatrix& cm)
+  {
+    auto t = std::make_shared<Tables>();
+
+    // Channel values are expanded to 8 bit with bit replication (see rgb565_to_color)
+    for (int out = 0; out < 3; out++) {
+      for (int v = 0; v < 32; v++) {
+        const int32_t v8 = (v << 3) | (v >> 2);
+        t->r[v][out] = cm.m[out][0] * v8 + cm.m[out][3] + ColorMatrix::ONE / 2;
+        t->b[v][out] = cm.m[out][2] * v8;
+      }
+      for (int v = 0; v < 64; v++) {
+        const int32_t v8 = (v << 2) | (v >> 4);
+        t->g[v][out] = cm.m[out][1] * v8;
+      }
+    }
+    return t;
+  }
+};
+
+}  // namespace gfx_blend
+}  // namespace esphome
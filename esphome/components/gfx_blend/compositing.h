@@ -0,0 +1,387 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+#include "esphome/core/color.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include "esphome/components/display/display_color_utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "defs.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * Porter-Duff compositing operators.
+ * Result = Fs * S + Fd * D for color and alpha, with S = source (layer) and D = destination.
+ */
+enum class PorterDuff : uint8_t {
+  CLEAR,     // Fs = 0,       Fd = 0
+  SRC,       // Fs = 1,       Fd = 0
+  DST,       // Fs = 0,       Fd = 1
+  SRC_OVER,  // Fs = 1,       Fd = 1 - As
+  DST_OVER,  // Fs = 1 - Ad,  Fd = 1
+  SRC_IN,    // Fs = Ad,      Fd = 0
+  DST_IN,    // Fs = 0,       Fd = As
+  SRC_OUT,   // Fs = 1 - Ad,  Fd = 0
+  DST_OUT,   // Fs = 0,       Fd = 1 - As
+  SRC_ATOP,  // Fs = Ad,      Fd = 1 - As
+  DST_ATOP,  // Fs = 1 - Ad,  Fd = As
+  XOR,       // Fs = 1 - Ad,  Fd = 1 - As
+};
+
+/**
+ * Pixel formats of offscreen layers. Colors are stored premultiplied by alpha.
+ * - ARGB4444: 16 bit per pixel (4 bit per channel), compact
+ * - RGB565_A8: 24 bit per pixel (RGB565 color plane + 8-bit alpha plane), full display precision
+ */
+enum class LayerFormat : uint8_t {
+  ARGB4444,
+  RGB565_A8,
+};
+
+namespace porter_duff {
+
+// Rounded division by 255 for products of two 8-bit values
+static inline uint32_t div255(uint32_t v)
+{
+  v += 128;
+  return (v + (v >> 8)) >> 8;
+}
+
+// Source and destination factors (0-255) of an operator for the given alphas
+template <PorterDuff OP>
+static inline void factors(uint32_t as, uint32_t ad, uint32_t& fs, uint32_t& fd)
+{
+  switch (OP) {
+    case PorterDuff::CLEAR:    fs = 0;        fd = 0;        break;
+    case PorterDuff::SRC:      fs = 255;      fd = 0;        break;
+    case PorterDuff::DST:      fs = 0;        fd = 255;      break;
+    case PorterDuff::SRC_OVER: fs = 255;      fd = 255 - as; break;
+    case PorterDuff::DST_OVER: fs = 255 - ad; fd = 255;      break;
+    case PorterDuff::SRC_IN:   fs = ad;       fd = 0;        break;
+    case PorterDuff::DST_IN:   fs = 0;        fd = as;       break;
+    case PorterDuff::SRC_OUT:  fs = 255 - ad; fd = 0;        break;
+    case PorterDuff::DST_OUT:  fs = 0;        fd = 255 - as; break;
+    case PorterDuff::SRC_ATOP: fs = ad;       fd = 255 - as; break;
+    case PorterDuff::DST_ATOP: fs = 255 - ad; fd = as;       break;
+    case PorterDuff::XOR:      fs = 255 - ad; fd = 255 - as; break;
+  }
+}
+
+/**
+ * Composites `n` source pixels onto `n` destination pixels in place.
+ * Colors are premultiplied RGB565, alphas 8 bit. The operator is a template parameter, so the
+ * factor selection compiles down to the few multiplications the operator actually needs.
+ */
+template <PorterDuff OP>
+static inline void HOT span(uint16_t* dst_c, uint8_t* dst_a, const uint16_t* src_c, const uint8_t* src_a, int n)
+{
+  for (int i = 0; i < n; i++) {
+    const uint32_t as = src_a[i];
+    const uint32_t ad = dst_a[i];
+
+    uint32_t fs, fd;
+    factors<OP>(as, ad, fs, fd);
+
+    // Common trivial cases: destination unchanged or replaced by the source
+    if (fs == 0 && fd == 255) continue;
+    if (fs == 255 && fd == 0) {
+      dst_c[i] = src_c[i];
+      dst_a[i] = as;
+      continue;
+    }
+
+    const uint32_t s = src_c[i];
+    const uint32_t d = dst_c[i];
+
+    uint32_t r = div255((s >> 11) * fs + (d >> 11) * fd);
+    uint32_t g = div255(((s >> 5) & 0x3F) * fs + ((d >> 5) & 0x3F) * fd);
+    uint32_t b = div255((s & 0x1F) * fs + (d & 0x1F) * fd);
+    uint32_t a = div255(as * fs + ad * fd);
+
+    // Rounding may overshoot by one for valid premultiplied inputs
+    if (r > 31) r = 31;
+    if (g > 63) g = 63;
+    if (b > 31) b = 31;
+    if (a > 255) a = 255;
+
+    dst_c[i] = uint16_t((r << 11) | (g << 5) | b);
+    dst_a[i] = uint8_t(a);
+  }
+}
+
+// Runtime operator selection, once per span
+static inline void span(PorterDuff op, uint16_t* dst_c, uint8_t* dst_a, const uint16_t* src_c, const uint8_t* src_a,
+                        int n)
+{
+  switch (op) {
+    case PorterDuff::CLEAR:    span<PorterDuff::CLEAR>(dst_c, dst_a, src_c, src_a, n);    break;
+    case PorterDuff::SRC:      span<PorterDuff::SRC>(dst_c, dst_a, src_c, src_a, n);      break;
+    case PorterDuff::DST:      break;
+    case PorterDuff::SRC_OVER: span<PorterDuff::SRC_OVER>(dst_c, dst_a, src_c, src_a, n); break;
+    case PorterDuff::DST_OVER: span<PorterDuff::DST_OVER>(dst_c, dst_a, src_c, src_a, n); break;
+    case PorterDuff::SRC_IN:   span<PorterDuff::SRC_IN>(dst_c, dst_a, src_c, src_a, n);   break;
+    case PorterDuff::DST_IN:   span<PorterDuff::DST_IN>(dst_c, dst_a, src_c, src_a, n);   break;
+    case PorterDuff::SRC_OUT:  span<PorterDuff::SRC_OUT>(dst_c, dst_a, src_c, src_a, n);  break;
+    case PorterDuff::DST_OUT:  span<PorterDuff::DST_OUT>(dst_c, dst_a, src_c, src_a, n);  break;
+    case PorterDuff::SRC_ATOP: span<PorterDuff::SRC_ATOP>(dst_c, dst_a, src_c, src_a, n); break;
+    case PorterDuff::DST_ATOP: span<PorterDuff::DST_ATOP>(dst_c, dst_a, src_c, src_a, n); break;
+    case PorterDuff::XOR:      span<PorterDuff::XOR>(dst_c, dst_a, src_c, src_a, n);      break;
+  }
+}
+
+// Multiplies premultiplied colors and alphas by a global opacity (0-255)
+static inline void HOT scale_span(uint16_t* c, uint8_t* a, uint8_t opacity, int n)
+{
+  if (opacity == 255) return;
+  for (int i = 0; i < n; i++) {
+    const uint32_t v = c[i];
+    c[i] = uint16_t((div255((v >> 11) * opacity) << 11) | (div255(((v >> 5) & 0x3F) * opacity) << 5) |
+                    div255((v & 0x1F) * opacity));
+    a[i] = uint8_t(div255(a[i] * opacity));
+  }
+}
+
+// Premultiplies a straight RGB565 color by an alpha (0-255)
+static inline uint16_t premultiply(uint16_t c, uint8_t alpha)
+{
+  if (alpha == 255) return c;
+  return uint16_t((div255((c >> 11) * alpha) << 11) | (div255(((c >> 5) & 0x3F) * alpha) << 5) |
+                  div255((c & 0x1F) * alpha));
+}
+
+}  // namespace porter_duff
+
+/**
+ * Offscreen layer with per-pixel alpha, composited onto the display (or another layer) with
+ * Porter-Duff operators. The pixel memory prefers PSRAM (RAMAllocator).
+ *
+ * All access goes through spans of premultiplied RGB565 colors plus 8-bit alphas, so the
+ * compositing kernels are shared by both formats.
+ *
+ * Usage:
+ * static GfxLayer badge(60, 30, GfxLayerFormat::ARGB4444);
+ * badge.clear();
+ * badge.fill(0, 0, 60, 30, Color(255, 0, 0), 200);
+ * badge.fill(10, 5, 40, 20, Color(0, 0, 0), 255, GfxPorterDuff::DST_OUT);  // Punch a hole
+ * gfx.composite(badge, 100, 40);
+ */
+class Layer {
+public:
+  Layer(int w, int h, LayerFormat format = LayerFormat::RGB565_A8) : w_(w), h_(h), format_(format)
+  {
+    if (w <= 0 || h <= 0) {
+      this->w_ = this->h_ = 0;
+      return;
+    }
+
+    // ARGB4444 uses the color plane only; RGB565_A8 adds a separate alpha plane
+    RAMAllocator<uint16_t> allocator;
+    uint16_t* pixels = allocator.allocate(this->size_());
+    if (pixels == nullptr) {
+      ESP_LOGE("gfx_blend.layer", "Could not allocate %dx%d layer", w, h);
+      this->w_ = this->h_ = 0;
+      return;
+    }
+    this->pixels_.reset(pixels);
+
+    if (format == LayerFormat::RGB565_A8) {
+      RAMAllocator<uint8_t> alpha_allocator;
+      uint8_t* alpha = alpha_allocator.allocate(this->size_());
+      if (alpha == nullptr) {
+        ESP_LOGE("gfx_blend.layer", "Could not allocate %dx%d alpha plane", w, h);
+        this->pixels_.reset();
+        this->w_ = this->h_ = 0;
+        return;
+      }
+      this->alpha_.reset(alpha);
+    }
+    this->clear();
+  }
+
+  int get_width() const { return this->w_; }
+  int get_height() const { return this->h_; }
+  LayerFormat get_format() const { return this->format_; }
+  bool is_valid() const { return this->pixels_ != nullptr; }
+
+  // Makes the whole layer fully transparent
+  void clear()
+  {
+    if (!this->is_valid()) return;
+    std::fill(this->pixels_.get(), this->pixels_.get() + this->size_(), 0);
+    if (this->alpha_) std::fill(this->alpha_.get(), this->alpha_.get() + this->size_(), 0);
+  }
+
+  /**
+   * Composites a solid color with the given alpha onto a rectangle of the layer.
+   * With PorterDuff::SRC the rectangle is replaced (e.g. alpha 0 erases it).
+   */
+  void fill(int x, int y, int w, int h, Color color, uint8_t alpha = 255, PorterDuff op = PorterDuff::SRC_OVER)
+  {
+    if (!this->clip_(x, y, w, h)) return;
+
+    const uint16_t c565 = porter_duff::premultiply(
+        display::ColorUtil::color_to_565(color, display::ColorOrder::COLOR_ORDER_RGB), alpha);
+    uint16_t src_c[SPAN_CHUNK], dst_c[SPAN_CHUNK];
+    uint8_t src_a[SPAN_CHUNK], dst_a[SPAN_CHUNK];
+    std::fill(src_c, src_c + SPAN_CHUNK, c565);
+    std::fill(src_a, src_a + SPAN_CHUNK, alpha);
+
+    for (int row = y; row < y + h; row++) {
+      for (int i = 0; i < w; i += SPAN_CHUNK) {
+        const int n = std::min(SPAN_CHUNK, w - i);
+        this->load_span(x + i, row, dst_c, dst_a, n);
+        porter_duff::span(op, dst_c, dst_a, src_c, src_a, n);
+        this->store_span(x + i, row, dst_c, dst_a, n);
+      }
+    }
+  }
+
+  // Sets a single pixel (straight color and alpha), replacing the previous value
+  void draw_pixel(int x, int y, Color color, uint8_t alpha = 255)
+  {
+    if (x < 0 || y < 0 || x >= this->w_ || y >= this->h_ || !this->is_valid()) return;
+    const uint16_t c565 = porter_duff::premultiply(
+        display::ColorUtil::color_to_565(color, display::ColorOrder::COLOR_ORDER_RGB), alpha);
+    this->store_span(x, y, &c565, &alpha, 1);
+  }
+
+  /**
+   * Composites another layer onto this one at (x, y).
+   */
+  void composite(const Layer& src, int x, int y, PorterDuff op = PorterDuff::SRC_OVER, uint8_t opacity = 255)
+  {
+    int sx = 0, sy = 0, w = src.w_, h = src.h_;
+    if (!src.is_valid() || !this->clip_(x, y, w, h, &sx, &sy)) return;
+
+    uint16_t src_c[SPAN_CHUNK], dst_c[SPAN_CHUNK];
+    uint8_t src_a[SPAN_CHUNK], dst_a[SPAN_CHUNK];
+
+    for (int row = 0; row < h; row++) {
+      for (int i = 0; i < w; i += SPAN_CHUNK) {
+        const int n = std::min(SPAN_CHUNK, w - i);
+        src.load_span(sx + i, sy + row, src_c, src_a, n);
+        porter_duff::scale_span(src_c, src_a, opacity, n);
+        this->load_span(x + i, y + row, dst_c, dst_a, n);
+        porter_duff::span(op, dst_c, dst_a, src_c, src_a, n);
+        this->store_span(x + i, y + row, dst_c, dst_a, n);
+      }
+    }
+  }
+
+  /**
+   * Reads `n` pixels starting at (x, y) as premultiplied RGB565 colors and 8-bit alphas.
+   * The caller guarantees that the span lies inside the layer.
+   */
+  inline void HOT load_span(int x, int y, uint16_t* c, uint8_t* a, int n) const
+  {
+    const size_t pos = size_t(y) * this->w_ + x;
+    const uint16_t* px = this->pixels_.get() + pos;
+
+    if (this->format_ == LayerFormat::RGB565_A8) {
+      std::copy(px, px + n, c);
+      std::copy(this->alpha_.get() + pos, this->alpha_.get() + pos + n, a);
+      return;
+    }
+
+    // ARGB4444: expand every channel with bit replication
+    for (int i = 0; i < n; i++) {
+      const uint16_t v = px[i];
+      const uint32_t a4 = v >> 12, r4 = (v >> 8) & 0xF, g4 = (v >> 4) & 0xF, b4 = v & 0xF;
+      c[i] = uint16_t((((r4 << 1) | (r4 >> 3)) << 11) | (((g4 << 2) | (g4 >> 2)) << 5) | ((b4 << 1) | (b4 >> 3)));
+      a[i] = uint8_t(a4 * 17);
+    }
+  }
+
+  /**
+   * Writes `n` premultiplied pixels starting at (x, y); counterpart of load_span().
+   */
+  inline void HOT store_span(int x, int y, const uint16_t* c, const uint8_t* a, int n)
+  {
+    const size_t pos = size_t(y) * this->w_ + x;
+    uint16_t* px = this->pixels_.get() + pos;
+
+    if (this->format_ == LayerFormat::RGB565_A8) {
+      std::copy(c, c + n, px);
+      std::copy(a, a + n, this->alpha_.get() + pos);
+      return;
+    }
+
+    // ARGB4444: round every channel to 4 bit; colors must not exceed the alpha after rounding
+    for (int i = 0; i < n; i++) {
+      const uint32_t v = c[i];
+      const uint32_t a4 = (a[i] + 8) / 17;
+      uint32_t r4 = ((v >> 11) * 15 + 15) / 31;
+      uint32_t g4 = (((v >> 5) & 0x3F) * 15 + 31) / 63;
+      uint32_t b4 = ((v & 0x1F) * 15 + 15) / 31;
+      if (r4 > a4) r4 = a4;
+      if (g4 > a4) g4 = a4;
+      if (b4 > a4) b4 = a4;
+      px[i] = uint16_t((a4 << 12) | (r4 << 8) | (g4 << 4) | b4);
+    }
+  }
+
+protected:
+  template <typename T>
+  struct Deleter {
+    void operator()(T* p) const
+    {
+      RAMAllocator<T> allocator;
+      allocator.deallocate(p, 0);
+    }
+  };
+
+  int w_;
+  int h_;
+  LayerFormat format_;
+  std::unique_ptr<uint16_t, Deleter<uint16_t>> pixels_;  // Premultiplied RGB565 or ARGB4444
+  std::unique_ptr<uint8_t, Deleter<uint8_t>> alpha_;     // RGB565_A8 only
+
+  size_t size_() const { return size_t(this->w_) * this->h_; }
+
+  /**
+   * Clips a rectangle to the layer. If `sx`/`sy` are given, they receive the offset of the
+   * visible part inside the (source) rectangle.
+   */
+  bool clip_(int& x, int& y, int& w, int& h, int* sx = nullptr, int* sy = nullptr) const
+  {
+    if (!this->is_valid()) return false;
+    if (x < 0) {
+      if (sx) *sx -= x;
+      w += x;
+      x = 0;
+    }
+    if (y < 0) {
+      if (sy) *sy -= y;
+      h += y;
+      y = 0;
+    }
+    if (x + w > this->w_) w = this->w_ - x;
+    if (y + h > this->h_) h = this->h_ - y;
+    return w > 0 && h > 0;
+  }
+};
+
+}  // namespace gfx_blend
+
+using GfxLayer = gfx_blend::Layer;
+using GfxLayerFormat = gfx_blend::LayerFormat;
+using GfxPorterDuff = gfx_blend::PorterDuff;
+
+}  // namespace esphome
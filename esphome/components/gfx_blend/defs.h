@@ -7,18 +7,25 @@
  * 
  * @author fschroedter
  * @copyright MIT License
- * @note This library requires a 16-bit color display (RGB565).
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
  */
 
 
 #pragma once
 #include "esphome/core/color.h"
+#include "esphome/core/defines.h"
 
 #include <cstdint>
 #include <functional>
 #include <type_traits>
 #include <vector>
 
+#ifdef USE_FRAME_PROFILER
+#include "esphome/components/frame_profiler/frame_profiler.h"
+#else
+#define FRAME_PROFILER_SCOPE(phase)
+#endif
+
 namespace esphome {
 namespace gfx_blend {
 /**
@@ -27,6 +34,46 @@ namespace gfx_blend {
  */
 using blender_t = std::function<uint16_t(int16_t x, int16_t y, uint16_t fg, uint16_t bg)>;
 
+/**
+ * Number of pixels processed per span step. Spans are split into chunks of this size
+ * so that the working buffers can live on the stack.
+ */
+static constexpr int SPAN_CHUNK = 64;
+
+/**
+ * Edge length of the square blocks used for raw framebuffer transfers. On displays rotated by
+ * 90 or 270 degrees a logical row is a native column; moving TILE_SIZE x TILE_SIZE blocks turns
+ * the strided accesses into short contiguous runs (16 pixels = 32 bytes, one cache line).
+ */
+static constexpr int TILE_SIZE = 16;
+
+/**
+ * Axis-aligned clip rectangle in logical display coordinates.
+ */
+struct ClipRect {
+  int16_t x{0};
+  int16_t y{0};
+  int16_t w{0};
+  int16_t h{0};
+
+  inline bool contains(int px, int py) const { return px >= x && py >= y && px < x + w && py < y + h; }
+  inline bool intersects(int rx, int ry, int rw, int rh) const
+  {
+    return rw > 0 && rh > 0 && rx < x + w && ry < y + h && rx + rw > x && ry + rh > y;
+  }
+
+  // Intersection of both rectangles (empty if they do not overlap)
+  ClipRect intersect(int rx, int ry, int rw, int rh) const
+  {
+    const int x0 = rx > x ? rx : x;
+    const int y0 = ry > y ? ry : y;
+    const int x1 = (rx + rw < x + w) ? rx + rw : x + w;
+    const int y1 = (ry + rh < y + h) ? ry + rh : y + h;
+    if (x1 <= x0 || y1 <= y0) return ClipRect{int16_t(x0), int16_t(y0), 0, 0};
+    return ClipRect{int16_t(x0), int16_t(y0), int16_t(x1 - x0), int16_t(y1 - y0)};
+  }
+};
+
 /**
  * Wrapper for effects that do not require background read access.
  * Statically marks the type with needs_bg to enable hardware optimizations.
@@ -82,6 +129,15 @@ struct BgAsSourceWrapper {
       return func(x, y, bg, bg);
     }
   }
+
+  // Span form of a single effect that provides one: bg becomes the input of the whole run
+  template <typename U = T>
+    requires requires(const U& f, uint16_t* fg, const uint16_t* bg) { f.span(int16_t(0), int16_t(0), fg, bg, 0); }
+  void span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n) const
+  {
+    for (int i = 0; i < n; i++) fg[i] = bg[i];
+    func.span(x, y, fg, bg, n);
+  }
 };
 
 /**
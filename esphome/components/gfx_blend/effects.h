@@ -7,7 +7,7 @@
  * 
  * @author fschroedter
  * @copyright MIT License
- * @note This library requires a 16-bit color display (RGB565).
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
  */
 
 
@@ -17,6 +17,8 @@
 
 #include <cstdint>
 
+#include "blend_modes.h"
+#include "color_matrix.h"
 #include "defs.h"
 
 namespace esphome {
@@ -128,30 +130,61 @@ public:
   static inline uint16_t HOT grayscale(uint16_t fg, uint16_t bg, uint8_t intensity = 255)
   {
     // Extract channels
-    uint8_t r_5 = (bg >> 11) & 0x1F;
-    uint8_t g_6 = (bg >> 5) & 0x3F;
-    uint8_t b_5 = bg & 0x1F;
+    uint8_t r_5 = (fg >> 11) & 0x1F;
+    uint8_t g_6 = (fg >> 5) & 0x3F;
+    uint8_t b_5 = fg & 0x1F;
 
     // Expand to 8-bit using bit replication for true 0-255 range
     // This prevents the "muted gray" look by ensuring white is 255 and black is 0
-    uint32_t r = (r_5 << 3) | (r_5 >> 2);
-    uint32_t g = (g_6 << 2) | (g_6 >> 4);
-    uint32_t b = (b_5 << 3) | (b_5 >> 2);
+    int32_t r = (r_5 << 3) | (r_5 >> 2);
+    int32_t g = (g_6 << 2) | (g_6 >> 4);
+    int32_t b = (b_5 << 3) | (b_5 >> 2);
 
     // Calculate luminance (ITU-R BT.709 formula)
-    // Using integer math for performance: (R*77 + G*150 + B*29) / 256
-    uint32_t lum = (r * 54 + g * 183 + b * 19) >> 8;
+    // Using integer math for performance: (R*54 + G*183 + B*19) / 256
+    int32_t lum = (r * 54 + g * 183 + b * 19) >> 8;
 
-    if (intensity = 255) {
+    if (intensity == 255) {
       return (uint16_t)(((lum >> 3) << 11) | ((lum >> 2) << 5) | (lum >> 3));
     }
 
-    uint32_t res_r = r + ((intensity * (lum - r)) >> 8);
-    uint32_t res_g = g + ((intensity * (lum - g)) >> 8);
-    uint32_t res_b = b + ((intensity * (lum - b)) >> 8);
+    // Signed math: the channel may be brighter than the luminance
+    int32_t res_r = r + ((intensity * (lum - r)) >> 8);
+    int32_t res_g = g + ((intensity * (lum - g)) >> 8);
+    int32_t res_b = b + ((intensity * (lum - b)) >> 8);
     return (uint16_t)(((res_r >> 3) << 11) | ((res_g >> 2) << 5) | (res_b >> 3));
   }
 
+  // Pipeline form of grayscale(): GfxEffects::grayscale(128) for a half desaturated result
+  static inline blender_t HOT grayscale(uint8_t intensity = 255)
+  {
+    return [intensity](int16_t x, int16_t y, uint16_t fg, uint16_t bg) -> uint16_t {  //
+      return Effects::grayscale(fg, bg, intensity);
+    };
+  }
+
+  // --------------------------------------------------------------------------------------
+  // Blend modes (W3C separable modes, fg = source, bg = backdrop)
+  // Usage: gfx.with(GfxEffects::multiply, [&]() { ... });
+  // Each mode provides a per-pixel form and a span form that handles two packed pixels at a time.
+  // --------------------------------------------------------------------------------------
+  static constexpr BlendMode<blend_ops::Multiply> multiply{};
+  static constexpr BlendMode<blend_ops::Screen> screen{};
+  static constexpr BlendMode<blend_ops::Overlay> overlay{};
+  static constexpr BlendMode<blend_ops::Darken> darken{};
+  static constexpr BlendMode<blend_ops::Lighten> lighten{};
+  static constexpr BlendMode<blend_ops::Difference> difference{};
+  static constexpr BlendMode<blend_ops::SoftLight> soft_light{};
+  static constexpr BlendMode<blend_ops::ColorDodge> color_dodge{};
+  static constexpr BlendMode<blend_ops::ColorBurn> color_burn{};
+
+  /**
+   * @brief Fused color adjustment: one fixed-point 3x4 matrix per pixel, however many adjustments it combines.
+   * Usage: GfxEffects::color_matrix(GfxColorMatrix::contrast(1.2f).then(GfxColorMatrix::saturation(0.3f)))
+   * @param matrix Composed color matrix (see ColorMatrix helpers).
+   */
+  static inline ColorMatrixEffect color_matrix(const ColorMatrix& matrix) { return ColorMatrixEffect(matrix); }
+
   static auto image_mask(esphome::image::Image* img, int16_t rel_x = 0, int16_t rel_y = 0)
   {
     return [img, rel_x, rel_y](int16_t x, int16_t y, uint16_t fg, uint16_t bg) -> uint16_t {  //
@@ -159,6 +192,31 @@ public:
     };
   }
 
+  /**
+   * @brief Blends a solid color over a span of RGB565 pixels using per-pixel coverage.
+   * All three channels are blended at once: the pixel is spread to 0x07E0F81F so that every
+   * channel has enough headroom for a multiplication with a 5-bit alpha.
+   * @param dst Span of background pixels, overwritten with the result.
+   * @param color Solid foreground color (RGB565).
+   * @param mask Coverage per pixel (0-255).
+   * @param opacity Global opacity applied on top of the mask (0-255).
+   * @param n Number of pixels.
+   */
+  static inline void HOT alpha_mask_span(uint16_t* dst, uint16_t color, const uint8_t* mask, uint8_t opacity, int n)
+  {
+    const uint32_t fg = (color | (uint32_t(color) << 16)) & 0x07E0F81F;
+
+    for (int i = 0; i < n; i++) {
+      uint32_t a = (uint32_t(mask[i]) * opacity + 255) >> 8;  // 0-255
+      if (a == 0) continue;
+
+      a = (a + 4) >> 3;  // 0-32
+      uint32_t bg = (dst[i] | (uint32_t(dst[i]) << 16)) & 0x07E0F81F;
+      uint32_t res = ((fg * a + bg * (32 - a)) >> 5) & 0x07E0F81F;
+      dst[i] = uint16_t(res | (res >> 16));
+    }
+  }
+
 protected:
   /**
    * @brief Performs hardware-optimized alpha blending on two RGB565 colors.
@@ -249,5 +307,6 @@ protected:
 }  // namespace gfx_blend
 
 using GfxEffects = gfx_blend::Effects;
+using GfxColorMatrix = gfx_blend::ColorMatrix;
 
 }  // namespace esphome
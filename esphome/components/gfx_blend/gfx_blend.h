@@ -7,7 +7,7 @@
  * 
  * @author fschroedter
  * @copyright MIT License
- * @note This library requires a 16-bit color display (RGB565).
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
  */
 
 #include "esphome/core/color.h"
@@ -17,15 +17,31 @@
 #include "esphome/components/display/display_buffer.h"
 #include "esphome/components/display/display_color_utils.h"
 
+#include <algorithm>
+#include <array>
 #include <initializer_list>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#elif defined(USE_HOST)
+#include <thread>
+#endif
+
 #include "accessor.h"
+#include "blur.h"
+#include "compositing.h"
 #include "defs.h"
 #include "effects.h"
+#include "lut.h"
+#include "pixel_format.h"
 #include "proxy.h"
+#include "shadow.h"
 #include "shapes.h"
 
 namespace esphome {
@@ -33,8 +49,9 @@ namespace gfx_blend {
 
 static const char* const TAG = "gfx_blend";
 static constexpr const char* MODULE_NAME = "GfxBlend";
-
-class GfxBlend;
+static constexpr uint8_t CLIP_STACK_DEPTH = 8;        // Maximum nesting of push_clip()
+static constexpr uint8_t MAX_RENDER_WORKERS = 4;      // Upper limit for render_parallel()
+static constexpr uint32_t WORKER_STACK_SIZE = 8192;  // Stack of a render_parallel() worker task (bytes)
 
 /**
  * Abstract base class for all steps in the graphics pipeline.
@@ -44,6 +61,15 @@ class GfxPipelineStep {
 public:
   virtual ~GfxPipelineStep() = default;
   virtual uint16_t blend(int16_t x, int16_t y, uint16_t fg, uint16_t bg) = 0;
+
+  /**
+   * Processes a horizontal run of `n` pixels starting at (x, y). `fg` is updated in place.
+   * The default falls back to blend() per pixel.
+   */
+  virtual void blend_span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n)
+  {
+    for (int i = 0; i < n; i++) fg[i] = this->blend(x + i, y, fg[i], bg[i]);
+  }
 };
 
 /**
@@ -57,10 +83,8 @@ public:
 
   uint16_t blend(int16_t x, int16_t y, uint16_t fg, uint16_t bg) override
   {
-    using EffectDef = std::decay_t<F>;
-
-    // If the wrapper indicates that bg is the source:
-    if constexpr (requires { typename EffectDef::use_bg_as_source; }) {
+    // If the effect indicates that bg is the source:
+    if constexpr (BG_AS_SOURCE) {
       // For 'use_bg_as_source'==true override `fg` with `bg` before calling the function.
       return func_(x, y, bg, bg);
     } else {
@@ -68,7 +92,31 @@ public:
     }
   }
 
+  /**
+   * Uses the effect's own span form if it provides one:
+   * void span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n) const
+   * Otherwise the effect is called per pixel without a virtual call in between.
+   */
+  void blend_span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n) override
+  {
+    if constexpr (requires { func_.span(x, y, fg, bg, n); }) {
+      // Same override as in blend()
+      if constexpr (BG_AS_SOURCE) std::copy(bg, bg + n, fg);
+      func_.span(x, y, fg, bg, n);
+    } else {
+      for (int i = 0; i < n; i++) fg[i] = this->GenericEffect::blend(x + i, y, fg[i], bg[i]);
+    }
+  }
+
 protected:
+  static constexpr bool BG_AS_SOURCE = [] {
+    if constexpr (requires { std::decay_t<F>::use_bg_as_source; }) {
+      return bool(std::decay_t<F>::use_bg_as_source);
+    } else {
+      return false;
+    }
+  }();
+
   F func_;
 };
 
@@ -80,9 +128,13 @@ protected:
  *
  * The class blends new pixel data with existing content by reading the
  * current framebuffer and combining it with the incoming color values.
+ *
+ * @tparam Format Framebuffer pixel format (see pixel_format.h). Effects always work on RGB565;
+ *                the format only converts at the framebuffer boundary. GfxBlend = RGB565 big-endian.
  */
-class GfxBlend : public GfxShapes<GfxBlend> {
-  friend class GfxShapes<GfxBlend>;
+template <typename Format>
+class GfxBlendT : public GfxShapes<GfxBlendT<Format>> {
+  friend class GfxShapes<GfxBlendT<Format>>;
 
 public:
   /**
@@ -92,7 +144,7 @@ public:
   template <typename T, typename std::enable_if<std::is_base_of<esphome::display::DisplayBuffer, T>::value ||
                                                     std::is_base_of<esphome::display::Display, T>::value,
                                                 int>::type = 0>
-  GfxBlend(T* disp) : disp_(reinterpret_cast<esphome::display::DisplayBuffer*>(disp))
+  GfxBlendT(T* disp) : disp_(reinterpret_cast<esphome::display::DisplayBuffer*>(disp))
   {
     // Terminates the constructor body prematurely if the passed pointer is invalid
     if (this->disp_ == nullptr) {
@@ -102,9 +154,9 @@ public:
 
     ESP_LOGD(TAG, "GfxBlend initialized with verified DisplayBuffer.");
 
-    // Check if the display buffer supports 16-bit color
-    if (disp->get_display_type() != esphome::display::DisplayType::DISPLAY_TYPE_COLOR) {
-      ESP_LOGE(TAG, "Incompatible display: 16-bit RGB565 required for correct blending.");
+    // Check if the display type matches the framebuffer format
+    if (disp->get_display_type() != Format::DISPLAY_TYPE) {
+      ESP_LOGE(TAG, "Incompatible display: %s framebuffer required for correct blending.", Format::NAME);
     }
   }
 
@@ -123,6 +175,7 @@ public:
 
   const std::vector<std::unique_ptr<GfxPipelineStep>>& get_pipeline() const;
   uint16_t apply_pipeline(int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+  void apply_pipeline_span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n);
   void clear();
 
   template <typename D = void*>
@@ -131,12 +184,33 @@ public:
   template <typename... Args>
   void with(Args&&... args);
 
+  template <typename F>
+  LutEffect bake(const F& effect);
+
+  void blur_region(int x, int y, int w, int h, uint8_t radius);
+  BlurredBackground blurred_bg(int x, int y, int w, int h, uint8_t radius);
+  void composite(const Layer& layer, int x, int y, PorterDuff op = PorterDuff::SRC_OVER, uint8_t opacity = 255);
+
+  bool push_clip(int x, int y, int w, int h);
+  void pop_clip();
+  bool has_clip() const { return this->clip_depth_ > 0; }
+  ClipRect get_clip();
+
+  template <typename F>
+  void render_parallel(uint8_t workers, F&& scene);
+
 protected:
   esphome::display::DisplayBuffer* disp_;  // Pointer to the target display buffer instance.
   bool read_bg_{true};                     // Indicates whether blender reads from the display buffer. default: true
   bool use_bg_as_source_{false};           // If true, start pipeline with bg instead of fg. default: false
 
   std::vector<std::unique_ptr<GfxPipelineStep>> pipeline_;  // Storage for the active pipeline steps.
+  ShadowCache shadow_cache_;                                 // Blurred shadow profiles, reused across frames.
+  std::array<ClipRect, CLIP_STACK_DEPTH> clip_stack_{};      // Intersected clip rectangles, top at clip_depth_ - 1.
+  uint8_t clip_depth_{0};                                    // Number of active clip rectangles.
+  uint16_t clip_overflow_{0};  // push_clip() calls rejected on a full stack, undone first by pop_clip().
+  bool raw_output_{false};  // Band worker: write final pixels raw, the owner marks the dirty region.
+  std::array<std::unique_ptr<GfxBlendT>, MAX_RENDER_WORKERS> workers_{};  // Band canvases of render_parallel().
 
   esphome::display::DisplayBuffer* get_real_display() { return this->disp_; }
 
@@ -171,23 +245,35 @@ protected:
    */
   template <typename F>
   void add_step_internal_(F&& func);
+  inline uint32_t HOT raw_pixel_offset_(int x, int y);
   inline uint16_t HOT read_raw_pixel_from_buffer_(int x, int y);
+  inline void HOT write_raw_pixel_to_buffer_(int x, int y, uint16_t color);
+  inline void HOT put_pixel_(int x, int y, uint16_t color);
+  bool is_transposed_() const;
+  void read_raw_block_(int x, int y, int w, int h, uint16_t* dst, int stride);
+  void write_raw_block_(int x, int y, int w, int h, const uint16_t* src, int stride);
+  bool clip_to_display_(int& x, int& y, int& w, int& h);
+  bool clip_to_visible_(int& x, int& y, int& w, int& h);
+  void mark_region_dirty_(int x, int y, int w, int h);
+  void draw_shadow_(int x, int y, int w, int h, int r, const Shadow& shadow);
   const char* display_type_to_string_(uint8_t type);
 
   template <typename TBlender>
   friend class GfxProxy;
+  template <typename TCanvas>
+  friend struct PipelineBlender;
+  template <typename TCanvas>
+  friend struct PassThroughBlender;
 };
 
 
 /**
- * Reads a pixel color from the display's raw RGB565 buffer.
+ * Maps logical coordinates to the byte offset in the display's raw buffer.
  * Handles rotation by mapping coordinates back to the native hardware layout.
  */
-inline uint16_t HOT GfxBlend::read_raw_pixel_from_buffer_(int x, int y)
+template <typename Format>
+inline uint32_t HOT GfxBlendT<Format>::raw_pixel_offset_(int x, int y)
 {
-  uint8_t* buffer = DisplayBufferAccessor::get_raw_buffer(this->disp_);
-  if (!buffer) return 0x0000;
-
   int native_w = DisplayBufferAccessor::get_native_w(this->disp_);
 
   // Optimization: Access native_h only when needed and use direct mapping.
@@ -213,22 +299,532 @@ inline uint16_t HOT GfxBlend::read_raw_pixel_from_buffer_(int x, int y)
       break;
   }
 
-  // Calculate buffer position (RGB565 = 2 bytes per pixel)
-  uint32_t pos = (y * native_w + x) * 2;
-  uint16_t raw = (uint16_t(buffer[pos]) << 8) | buffer[pos + 1];
+  // Calculate buffer position (e.g. RGB565 = 2 bytes per pixel)
+  return (y * native_w + x) * Format::BYTES;
+}
 
-  return raw;
+/**
+ * Reads a pixel from the display's raw buffer and converts it to RGB565.
+ */
+template <typename Format>
+inline uint16_t HOT GfxBlendT<Format>::read_raw_pixel_from_buffer_(int x, int y)
+{
+  uint8_t* buffer = DisplayBufferAccessor::get_raw_buffer(this->disp_);
+  if (!buffer) return 0x0000;
+
+  return Format::load(buffer + this->raw_pixel_offset_(x, y));
 }
 
+/**
+ * Writes an RGB565 color directly into the display's raw buffer (converted to the buffer format).
+ * Bypasses the display driver; callers must report the touched area via mark_region_dirty_().
+ */
+template <typename Format>
+inline void HOT GfxBlendT<Format>::write_raw_pixel_to_buffer_(int x, int y, uint16_t color)
+{
+  uint8_t* buffer = DisplayBufferAccessor::get_raw_buffer(this->disp_);
+  if (!buffer) return;
 
-void GfxBlend::dump_config()
+  Format::store(buffer + this->raw_pixel_offset_(x, y), color);
+}
+
+/**
+ * Writes a final pixel color produced by the proxy.
+ * Normally goes through the display driver (which tracks the dirty window); band workers of
+ * render_parallel() write raw, because driver state must not be touched from several tasks.
+ */
+template <typename Format>
+inline void HOT GfxBlendT<Format>::put_pixel_(int x, int y, uint16_t color)
+{
+  if (this->raw_output_) {
+    this->write_raw_pixel_to_buffer_(x, y, color);
+  } else {
+    this->disp_->draw_pixel_at(x, y, rgb565_to_color(color));
+  }
+}
+
+/**
+ * True if logical rows run along native columns (rotation by 90 or 270 degrees).
+ */
+template <typename Format>
+bool GfxBlendT<Format>::is_transposed_() const
+{
+  const auto rotation = this->disp_->get_rotation();
+  return rotation == esphome::display::DISPLAY_ROTATION_90_DEGREES ||
+         rotation == esphome::display::DISPLAY_ROTATION_270_DEGREES;
+}
+
+/**
+ * Copies a logical rectangle of the raw framebuffer into `dst` (logical layout, `stride` pixels per row).
+ * On transposed displays the rectangle is walked in TILE_SIZE blocks along native rows, so every
+ * framebuffer access is part of a short contiguous run instead of a jump of one native row.
+ * The caller guarantees that the rectangle is inside the display.
+ */
+template <typename Format>
+void GfxBlendT<Format>::read_raw_block_(int x, int y, int w, int h, uint16_t* dst, int stride)
+{
+  uint8_t* buffer = DisplayBufferAccessor::get_raw_buffer(this->disp_);
+  if (!buffer || w <= 0 || h <= 0) return;
+  FRAME_PROFILER_SCOPE(WRITE);
+
+  const auto rotation = this->disp_->get_rotation();
+
+  if (!this->is_transposed_()) {
+    // Logical rows are native rows (reversed for 180 degrees)
+    const int step = (rotation == esphome::display::DISPLAY_ROTATION_180_DEGREES) ? -Format::BYTES : Format::BYTES;
+    for (int row = 0; row < h; row++) {
+      const uint8_t* src = buffer + this->raw_pixel_offset_(x, y + row);
+      uint16_t* out = dst + row * stride;
+      for (int i = 0; i < w; i++, src += step) out[i] = Format::load(src);
+    }
+    return;
+  }
+
+  // Logical columns are native rows: increasing logical y moves left (90) or right (270) in native memory
+  const int step = (rotation == esphome::display::DISPLAY_ROTATION_90_DEGREES) ? -Format::BYTES : Format::BYTES;
+  for (int by = 0; by < h; by += TILE_SIZE) {
+    const int bh = std::min(TILE_SIZE, h - by);
+    for (int col = 0; col < w; col++) {
+      const uint8_t* src = buffer + this->raw_pixel_offset_(x + col, y + by);
+      uint16_t* out = dst + by * stride + col;
+      for (int i = 0; i < bh; i++, src += step) out[i * stride] = Format::load(src);
+    }
+  }
+}
+
+/**
+ * Counterpart of read_raw_block_(): writes a logical rectangle into the raw framebuffer.
+ * Callers must report the touched area via mark_region_dirty_().
+ */
+template <typename Format>
+void GfxBlendT<Format>::write_raw_block_(int x, int y, int w, int h, const uint16_t* src, int stride)
+{
+  uint8_t* buffer = DisplayBufferAccessor::get_raw_buffer(this->disp_);
+  if (!buffer || w <= 0 || h <= 0) return;
+  FRAME_PROFILER_SCOPE(WRITE);
+
+  const auto rotation = this->disp_->get_rotation();
+
+  if (!this->is_transposed_()) {
+    const int step = (rotation == esphome::display::DISPLAY_ROTATION_180_DEGREES) ? -Format::BYTES : Format::BYTES;
+    for (int row = 0; row < h; row++) {
+      uint8_t* dst = buffer + this->raw_pixel_offset_(x, y + row);
+      const uint16_t* in = src + row * stride;
+      for (int i = 0; i < w; i++, dst += step) Format::store(dst, in[i]);
+    }
+    return;
+  }
+
+  const int step = (rotation == esphome::display::DISPLAY_ROTATION_90_DEGREES) ? -Format::BYTES : Format::BYTES;
+  for (int by = 0; by < h; by += TILE_SIZE) {
+    const int bh = std::min(TILE_SIZE, h - by);
+    for (int col = 0; col < w; col++) {
+      uint8_t* dst = buffer + this->raw_pixel_offset_(x + col, y + by);
+      const uint16_t* in = src + by * stride + col;
+      for (int i = 0; i < bh; i++, dst += step) Format::store(dst, in[i * stride]);
+    }
+  }
+}
+
+/**
+ * Clips a rectangle to the logical display area.
+ * @return false if nothing of the rectangle is visible.
+ */
+template <typename Format>
+bool GfxBlendT<Format>::clip_to_display_(int& x, int& y, int& w, int& h)
+{
+  const int disp_w = this->disp_->get_width();
+  const int disp_h = this->disp_->get_height();
+
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > disp_w) w = disp_w - x;
+  if (y + h > disp_h) h = disp_h - y;
+
+  return w > 0 && h > 0;
+}
+
+/**
+ * Clips a rectangle to the display and the active clip rectangle (if any).
+ * @return false if nothing of the rectangle is visible.
+ */
+template <typename Format>
+bool GfxBlendT<Format>::clip_to_visible_(int& x, int& y, int& w, int& h)
+{
+  if (!this->clip_to_display_(x, y, w, h)) return false;
+  if (this->clip_depth_ == 0) return true;
+
+  const ClipRect r = this->clip_stack_[this->clip_depth_ - 1].intersect(x, y, w, h);
+  x = r.x;
+  y = r.y;
+  w = r.w;
+  h = r.h;
+  return w > 0 && h > 0;
+}
+
+/**
+ * Restricts all following drawing (shapes, effects, blits) to the rectangle, intersected with
+ * the previously active clip. Calls nest up to CLIP_STACK_DEPTH levels.
+ * Usage: gfx.push_clip(0, 40, 172, 200); ... gfx.pop_clip();
+ * @return false if the stack is full (the clip is not changed then). The matching pop_clip() is
+ * still required and only undoes the rejected push, so the outer clips stay balanced.
+ */
+template <typename Format>
+bool GfxBlendT<Format>::push_clip(int x, int y, int w, int h)
+{
+  if (this->clip_depth_ >= CLIP_STACK_DEPTH) {
+    ESP_LOGW(TAG, "push_clip(): clip stack full (%u levels)", CLIP_STACK_DEPTH);
+    this->clip_overflow_++;
+    return false;
+  }
+
+  const ClipRect current = this->get_clip();
+  this->clip_stack_[this->clip_depth_++] = current.intersect(x, y, w, h);
+  return true;
+}
+
+/**
+ * Restores the clip rectangle that was active before the last push_clip().
+ */
+template <typename Format>
+void GfxBlendT<Format>::pop_clip()
+{
+  // Pushes beyond the stack depth were never applied; their pops must not remove a real clip
+  if (this->clip_overflow_ > 0) {
+    this->clip_overflow_--;
+    return;
+  }
+  if (this->clip_depth_ > 0) this->clip_depth_--;
+}
+
+/**
+ * Returns the active clip rectangle, or the whole display if no clip is set.
+ */
+template <typename Format>
+ClipRect GfxBlendT<Format>::get_clip()
+{
+  if (this->clip_depth_ > 0) return this->clip_stack_[this->clip_depth_ - 1];
+  return ClipRect{0, 0, int16_t(this->disp_->get_width()), int16_t(this->disp_->get_height())};
+}
+
+/**
+ * Renders a scene with several workers, each on its own horizontal band of the visible area.
+ *
+ * The scene is executed once per band on a separate canvas whose clip is set to the band, so
+ * shapes outside the band are rejected early and the rest is clipped per span. The band canvases
+ * are created on first use and kept (including their shadow caches). Band workers write
+ * raw into the framebuffer; the dirty region is reported once after all of them have finished.
+ * The calling task renders the first band itself.
+ *
+ * Workers are FreeRTOS tasks on ESP32 (limited to the number of cores) and threads on the host;
+ * elsewhere, or without a raw framebuffer, the scene simply runs once on this canvas. Single-core
+ * chips like the ESP32-C6 and ESP32-C3 therefore always take that path and gain nothing.
+ *
+ * The drawing commands are not recorded: the scene is called again for every band, concurrently.
+ * It must be pure and idempotent, i.e. draw the same thing on every call, only through the canvas
+ * it receives, and without modifying shared state (counters, animation steps, layers). Compute
+ * such values before render_parallel() and capture them by value.
+ * Effects that read neighbouring pixels (blur_region, blurred_bg) only see their own band.
+ *
+ * Usage: gfx.render_parallel(2, [&](auto& g) { g.filled_rectangle(0, 0, 172, 320, 12, Color(30, 30, 30)); ... });
+ * @param workers Number of bands (1 - MAX_RENDER_WORKERS).
+ * @param scene Callable taking the band canvas (GfxBlendT&).
+ */
+template <typename Format>
+template <typename F>
+void GfxBlendT<Format>::render_parallel(uint8_t workers, F&& scene)
+{
+  const ClipRect area = this->get_clip();
+
+#ifdef USE_ESP32
+  if (workers > portNUM_PROCESSORS) workers = portNUM_PROCESSORS;
+#elif !defined(USE_HOST)
+  workers = 1;
+#endif
+  if (workers > MAX_RENDER_WORKERS) workers = MAX_RENDER_WORKERS;
+  if (area.h < workers) workers = area.h > 0 ? area.h : 1;
+
+  if (workers <= 1 || DisplayBufferAccessor::get_raw_buffer(this->disp_) == nullptr) {
+    scene(*this);
+    return;
+  }
+
+  struct Job {
+    GfxBlendT<Format>* canvas;
+    std::remove_reference_t<F>* scene;
+    ClipRect band;
+#ifdef USE_ESP32
+    SemaphoreHandle_t done;
+#endif
+
+    void run()
+    {
+      this->canvas->clear();
+      this->canvas->clip_depth_ = 0;
+      this->canvas->clip_overflow_ = 0;
+      this->canvas->push_clip(this->band.x, this->band.y, this->band.w, this->band.h);
+      (*this->scene)(*this->canvas);
+      this->canvas->clear();
+    }
+  };
+
+  // Equal bands; the last one takes the remainder
+  std::array<Job, MAX_RENDER_WORKERS> jobs{};
+  const int band_h = area.h / workers;
+  for (uint8_t i = 0; i < workers; i++) {
+    // Band canvases are kept, so their shadow caches survive from frame to frame
+    if (!this->workers_[i]) {
+      this->workers_[i] = std::make_unique<GfxBlendT<Format>>(this->disp_);
+      this->workers_[i]->raw_output_ = true;
+    }
+
+    const int y = area.y + i * band_h;
+    const int h = (i == workers - 1) ? area.y + area.h - y : band_h;
+    jobs[i].canvas = this->workers_[i].get();
+    jobs[i].scene = &scene;
+    jobs[i].band = ClipRect{area.x, int16_t(y), area.w, int16_t(h)};
+  }
+
+#ifdef USE_ESP32
+  SemaphoreHandle_t done = xSemaphoreCreateCounting(workers, 0);
+  if (done == nullptr) {
+    ESP_LOGE(TAG, "render_parallel(): could not create semaphore");
+    scene(*this);
+    return;
+  }
+
+  uint8_t started = 0;
+  for (uint8_t i = 1; i < workers; i++) {
+    jobs[i].done = done;
+    auto task = [](void* arg) {
+      Job* job = static_cast<Job*>(arg);
+      job->run();
+      xSemaphoreGive(job->done);
+      vTaskDelete(nullptr);
+    };
+    if (xTaskCreatePinnedToCore(task, "gfx_band", WORKER_STACK_SIZE, &jobs[i], uxTaskPriorityGet(nullptr), nullptr,
+                                i % portNUM_PROCESSORS) == pdPASS) {
+      started++;
+    } else {
+      ESP_LOGW(TAG, "render_parallel(): could not start worker %u, rendering its band inline", i);
+      jobs[i].run();
+    }
+  }
+
+  jobs[0].run();
+
+  // Barrier: wait until every started worker has finished its band
+  for (uint8_t i = 0; i < started; i++) xSemaphoreTake(done, portMAX_DELAY);
+  vSemaphoreDelete(done);
+#elif defined(USE_HOST)
+  std::array<std::thread, MAX_RENDER_WORKERS> threads;
+  for (uint8_t i = 1; i < workers; i++) threads[i] = std::thread([&job = jobs[i]]() { job.run(); });
+
+  jobs[0].run();
+
+  for (uint8_t i = 1; i < workers; i++) threads[i].join();
+#endif
+
+  this->mark_region_dirty_(area.x, area.y, area.w, area.h);
+}
+
+/**
+ * Reports a region that was modified through raw buffer writes to the display driver.
+ * Drivers like ili9xxx only transfer the window touched via draw_pixel_at(), so the two corner
+ * pixels are drawn once with a changed and once with their real color to extend that window.
+ */
+template <typename Format>
+void GfxBlendT<Format>::mark_region_dirty_(int x, int y, int w, int h)
+{
+  // Band workers: the owner marks the whole area once after all workers are done
+  if (this->raw_output_) return;
+
+  const int corners[2][2] = {{x, y}, {x + w - 1, y + h - 1}};
+
+  for (auto const& corner : corners) {
+    uint16_t color = this->read_raw_pixel_from_buffer_(corner[0], corner[1]);
+    this->disp_->draw_pixel_at(corner[0], corner[1], rgb565_to_color(~color));
+    this->disp_->draw_pixel_at(corner[0], corner[1], rgb565_to_color(color));
+  }
+}
+
+/**
+ * Blurs a region of the framebuffer in place (separable box blur, three passes).
+ * Works on bands of TILE_SIZE rows and columns; no frame copy is made.
+ * Usage: gfx.blur_region(10, 10, 150, 80, 6);
+ * @param radius Box radius per pass (roughly the Gaussian sigma). 0 leaves the region untouched.
+ */
+template <typename Format>
+void GfxBlendT<Format>::blur_region(int x, int y, int w, int h, uint8_t radius)
+{
+  if (radius == 0 || DisplayBufferAccessor::get_raw_buffer(this->disp_) == nullptr) return;
+  if (!this->clip_to_visible_(x, y, w, h)) return;
+
+  BoxBlur blur(radius);
+  std::vector<uint16_t> block((w > h ? w : h) * TILE_SIZE);
+  std::vector<uint16_t> column(h);
+
+  // Horizontal passes, TILE_SIZE rows per block transfer
+  for (int row = 0; row < h; row += TILE_SIZE) {
+    const int n = std::min(TILE_SIZE, h - row);
+    this->read_raw_block_(x, y + row, w, n, block.data(), w);
+    {
+      FRAME_PROFILER_SCOPE(BLEND);
+      for (int i = 0; i < n; i++) blur.blur_line(&block[i * w], w);
+    }
+    this->write_raw_block_(x, y + row, w, n, block.data(), w);
+  }
+
+  // Vertical passes, TILE_SIZE columns per block transfer
+  for (int col = 0; col < w; col += TILE_SIZE) {
+    const int n = std::min(TILE_SIZE, w - col);
+    this->read_raw_block_(x + col, y, n, h, block.data(), TILE_SIZE);
+    {
+      FRAME_PROFILER_SCOPE(BLEND);
+      for (int c = 0; c < n; c++) {
+        for (int i = 0; i < h; i++) column[i] = block[i * TILE_SIZE + c];
+        blur.blur_line(column.data(), h);
+        for (int i = 0; i < h; i++) block[i * TILE_SIZE + c] = column[i];
+      }
+    }
+    this->write_raw_block_(x + col, y, n, h, block.data(), TILE_SIZE);
+  }
+
+  this->mark_region_dirty_(x, y, w, h);
+}
+
+/**
+ * Creates a pipeline source holding a blurred copy of the background region.
+ * The framebuffer itself is not modified; only the region (w * h pixels) is buffered.
+ * Usage: gfx.with(gfx.blurred_bg(x, y, w, h, 6), GfxEffects::alpha(200), [&]() { ... });
+ */
+template <typename Format>
+BlurredBackground GfxBlendT<Format>::blurred_bg(int x, int y, int w, int h, uint8_t radius)
+{
+  BlurredBackground source{int16_t(x), int16_t(y), 0, 0, nullptr};
+  if (DisplayBufferAccessor::get_raw_buffer(this->disp_) == nullptr) return source;
+  if (!this->clip_to_display_(x, y, w, h)) return source;
+
+  auto pixels = std::make_shared<std::vector<uint16_t>>(w * h);
+  uint16_t* data = pixels->data();
+
+  this->read_raw_block_(x, y, w, h, data, w);
+
+  FRAME_PROFILER_SCOPE(BLEND);
+  BoxBlur blur(radius);
+  std::vector<uint16_t> column(h);
+
+  for (int row = 0; row < h; row++) blur.blur_line(data + row * w, w);
+
+  for (int col = 0; col < w; col++) {
+    for (int i = 0; i < h; i++) column[i] = data[i * w + col];
+    blur.blur_line(column.data(), h);
+    for (int i = 0; i < h; i++) data[i * w + col] = column[i];
+  }
+
+  source.x = x;
+  source.y = y;
+  source.w = w;
+  source.h = h;
+  source.pixels = std::move(pixels);
+  return source;
+}
+
+/**
+ * Composites the cached shadow profile of a rounded rectangle onto the framebuffer.
+ * Each visible row is blended as one span; the profile is only generated on a cache miss.
+ */
+template <typename Format>
+void GfxBlendT<Format>::draw_shadow_(int x, int y, int w, int h, int r, const Shadow& shadow)
+{
+  if (w <= 0 || h <= 0 || shadow.opacity == 0) return;
+  if (DisplayBufferAccessor::get_raw_buffer(this->disp_) == nullptr) return;
+
+  const ShadowProfile& profile = this->shadow_cache_.get(w, h, r, shadow.blur);
+  const int stride = profile.stride();
+
+  // Top-left corner of the profile on the display, then the visible part of it
+  const int px = x + shadow.offset_x - profile.margin;
+  const int py = y + shadow.offset_y - profile.margin;
+  int cx = px, cy = py, cw = stride, ch = profile.rows();
+  if (!this->clip_to_visible_(cx, cy, cw, ch)) return;
+
+  const uint16_t color = display::ColorUtil::color_to_565(shadow.color, display::ColorOrder::COLOR_ORDER_RGB);
+  std::vector<uint16_t> block(cw * TILE_SIZE);
+
+  for (int band = 0; band < ch; band += TILE_SIZE) {
+    const int n = std::min(TILE_SIZE, ch - band);
+    this->read_raw_block_(cx, cy + band, cw, n, block.data(), cw);
+    {
+      FRAME_PROFILER_SCOPE(BLEND);
+      for (int row = 0; row < n; row++) {
+        const uint8_t* mask = &profile.alpha[(cy - py + band + row) * stride + (cx - px)];
+        Effects::alpha_mask_span(&block[row * cw], color, mask, shadow.opacity, cw);
+      }
+    }
+    this->write_raw_block_(cx, cy + band, cw, n, block.data(), cw);
+  }
+
+  this->mark_region_dirty_(cx, cy, cw, ch);
+}
+
+/**
+ * Composites an offscreen layer onto the framebuffer at (x, y).
+ * The framebuffer is opaque (alpha 255); the resulting alpha is dropped, so operators that leave
+ * pixels partly transparent (e.g. CLEAR, SRC_IN) show them as composited onto black.
+ * Usage: gfx.composite(layer, 10, 20, PorterDuff::SRC_OVER, 200);
+ */
+template <typename Format>
+void GfxBlendT<Format>::composite(const Layer& layer, int x, int y, PorterDuff op, uint8_t opacity)
+{
+  if (!layer.is_valid() || DisplayBufferAccessor::get_raw_buffer(this->disp_) == nullptr) return;
+
+  int cx = x, cy = y, cw = layer.get_width(), ch = layer.get_height();
+  if (!this->clip_to_visible_(cx, cy, cw, ch)) return;
+
+  uint16_t src_c[SPAN_CHUNK];
+  uint8_t src_a[SPAN_CHUNK], dst_a[SPAN_CHUNK];
+  std::vector<uint16_t> block(cw * TILE_SIZE);
+
+  for (int band = 0; band < ch; band += TILE_SIZE) {
+    const int rows = std::min(TILE_SIZE, ch - band);
+    this->read_raw_block_(cx, cy + band, cw, rows, block.data(), cw);
+    {
+      FRAME_PROFILER_SCOPE(BLEND);
+      for (int row = 0; row < rows; row++) {
+        for (int i = 0; i < cw; i += SPAN_CHUNK) {
+          const int n = std::min(SPAN_CHUNK, cw - i);
+
+          layer.load_span(cx + i - x, cy + band + row - y, src_c, src_a, n);
+          porter_duff::scale_span(src_c, src_a, opacity, n);
+          std::fill(dst_a, dst_a + n, 255);
+
+          porter_duff::span(op, &block[row * cw + i], dst_a, src_c, src_a, n);
+        }
+      }
+    }
+    this->write_raw_block_(cx, cy + band, cw, rows, block.data(), cw);
+  }
+
+  this->mark_region_dirty_(cx, cy, cw, ch);
+}
+
+template <typename Format>
+void GfxBlendT<Format>::dump_config()
 {
   ESP_LOGCONFIG(TAG, MODULE_NAME);
   const uint8_t type = this->disp_->get_display_type();
   ESP_LOGCONFIG(TAG, "  Target display: %s", this->display_type_to_string_(type));
+  ESP_LOGCONFIG(TAG, "  Pixel format: %s", Format::NAME);
 
-  if (type != esphome::display::DisplayType::DISPLAY_TYPE_COLOR) {
-    ESP_LOGE(TAG, "Incompatible display: 16-bit RGB565 required for correct blending");
+  if (type != Format::DISPLAY_TYPE) {
+    ESP_LOGE(TAG, "Incompatible display: %s framebuffer required for correct blending", Format::NAME);
   }
 
   ESP_LOGCONFIG(TAG, "  Width: %d", this->disp_->get_width());
@@ -241,8 +837,9 @@ void GfxBlend::dump_config()
  * Usage: gfx.needs_no_bg(E1, E2)
  */
 
+template <typename Format>
 template <typename... Args>
-auto GfxBlend::needs_no_bg(Args&&... args)
+auto GfxBlendT<Format>::needs_no_bg(Args&&... args)
 {
   return NoBgWrapper<std::vector<blender_t>>{create_vector_(std::forward<Args>(args)...)};
 }
@@ -251,7 +848,8 @@ auto GfxBlend::needs_no_bg(Args&&... args)
  * Overload of needs_no_bg for use with initialization lists {e1, e2}.
  * Usage: gfx.needs_no_bg({E1, E2})
  */
-auto GfxBlend::needs_no_bg(std::initializer_list<blender_t> effects)
+template <typename Format>
+auto GfxBlendT<Format>::needs_no_bg(std::initializer_list<blender_t> effects)
 {
   return NoBgWrapper<std::vector<blender_t>>{std::vector<blender_t>(effects)};
 }
@@ -259,19 +857,26 @@ auto GfxBlend::needs_no_bg(std::initializer_list<blender_t> effects)
 /**
  * Creates a BgAsSourceWrapper for multiple effects (variadic).
  * Causes the background content to serve as the input color for the effects.
- * Usage: gfx.bg_source(E1, E2)
+ * A single effect keeps its type, so its span form (if any) is still used.
+ * Usage: gfx.bg_as_source(E1, E2)
  */
+template <typename Format>
 template <typename... Args>
-auto GfxBlend::bg_as_source(Args&&... args)
+auto GfxBlendT<Format>::bg_as_source(Args&&... args)
 {
-  return BgAsSourceWrapper<std::vector<blender_t>>{create_vector_(std::forward<Args>(args)...)};
+  if constexpr (sizeof...(Args) == 1) {
+    return BgAsSourceWrapper<std::decay_t<Args>...>{std::forward<Args>(args)...};
+  } else {
+    return BgAsSourceWrapper<std::vector<blender_t>>{create_vector_(std::forward<Args>(args)...)};
+  }
 }
 
 /**
  * Overload of bg_as_source for use with initialization lists {e1, e2}.
  * gfx.bg_source({E1, E2})
  */
-auto GfxBlend::bg_as_source(std::initializer_list<blender_t> effects)
+template <typename Format>
+auto GfxBlendT<Format>::bg_as_source(std::initializer_list<blender_t> effects)
 {
   return BgAsSourceWrapper<std::vector<blender_t>>{std::vector<blender_t>(effects)};
 }
@@ -279,13 +884,18 @@ auto GfxBlend::bg_as_source(std::initializer_list<blender_t> effects)
 /**
  * Provides read access to the currently registered pipeline steps.
  */
-const std::vector<std::unique_ptr<GfxPipelineStep>>& GfxBlend::get_pipeline() const { return this->pipeline_; }
+template <typename Format>
+const std::vector<std::unique_ptr<GfxPipelineStep>>& GfxBlendT<Format>::get_pipeline() const
+{
+  return this->pipeline_;
+}
 
 /**
  * Processes a pixel through all steps of the pipeline.
  * @return The final pixel color after applying all blending operations.
  */
-uint16_t GfxBlend::apply_pipeline(int16_t x, int16_t y, uint16_t fg, uint16_t bg)
+template <typename Format>
+uint16_t GfxBlendT<Format>::apply_pipeline(int16_t x, int16_t y, uint16_t fg, uint16_t bg)
 {
   uint16_t current_fg = fg;
 
@@ -297,10 +907,25 @@ uint16_t GfxBlend::apply_pipeline(int16_t x, int16_t y, uint16_t fg, uint16_t bg
   return current_fg;
 }
 
+/**
+ * Processes a run of pixels through all steps of the pipeline.
+ * Same semantics as apply_pipeline(), but with one (virtual) call per step and span.
+ * @param fg Input colors, replaced by the final colors.
+ */
+template <typename Format>
+void GfxBlendT<Format>::apply_pipeline_span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n)
+{
+  FRAME_PROFILER_SCOPE(BLEND);
+  for (auto const& step : pipeline_) {
+    step->blend_span(x, y, fg, bg, n);
+  }
+}
+
 /**
  * Resets the pipeline: deletes all effects and restores default flags.
  */
-void GfxBlend::clear()
+template <typename Format>
+void GfxBlendT<Format>::clear()
 {
   this->pipeline_.clear();
   this->read_bg_ = true;
@@ -312,8 +937,9 @@ void GfxBlend::clear()
  * Executes draw_func and automatically clears the pipeline afterwards.
  * Usage: gfx.with({E1, E2}) or gfx.with({E1, E2}, Draw)
  */
+template <typename Format>
 template <typename D>
-void GfxBlend::with(std::initializer_list<blender_t> funcs, D&& draw_func)
+void GfxBlendT<Format>::with(std::initializer_list<blender_t> funcs, D&& draw_func)
 {
   this->clear();
 
@@ -335,8 +961,9 @@ void GfxBlend::with(std::initializer_list<blender_t> funcs, D&& draw_func)
  * Can accept wrappers, individual effects, or a final lambda.
  * Usage: gfx.with(E1, E2) or gfx.with(E1, E2, Draw)
  */
+template <typename Format>
 template <typename... Args>
-void GfxBlend::with(Args&&... args)
+void GfxBlendT<Format>::with(Args&&... args)
 {
   auto tuple = std::forward_as_tuple(std::forward<Args>(args)...);
   constexpr size_t n = sizeof...(Args);
@@ -359,8 +986,9 @@ void GfxBlend::with(Args&&... args)
 /**
  * Helper function to efficiently pack variadic arguments into a vector of effects.
  */
+template <typename Format>
 template <typename... Args>
-std::vector<blender_t> GfxBlend::create_vector_(Args&&... args)
+std::vector<blender_t> GfxBlendT<Format>::create_vector_(Args&&... args)
 {
   std::vector<blender_t> v;
   v.reserve(sizeof...(Args));
@@ -372,13 +1000,27 @@ std::vector<blender_t> GfxBlend::create_vector_(Args&&... args)
  * Helper function to unpack a tuple into individual pipeline steps.
  * Used internally for processing complex with() calls.
  */
+template <typename Format>
 template <typename Tpl, size_t... I>
-void GfxBlend::add_effects_from_tuple_(Tpl&& tpl, std::index_sequence<I...>)
+void GfxBlendT<Format>::add_effects_from_tuple_(Tpl&& tpl, std::index_sequence<I...>)
 {
   // Dieser Fold-Expression ruft add_step_internal für jeden Index auf
   (this->add_step_internal_(std::get<I>(std::forward<Tpl>(tpl))), ...);
 }
 
+/**
+ * Precomputes a unary effect (result depends on fg only) for all 65,536 RGB565 inputs.
+ * Channel-separable effects are stored as three small per-channel tables, all others as a
+ * 128 KB table (PSRAM if available). The returned effect costs one table lookup per pixel.
+ * Usage: static auto lut = gfx.bake(my_expensive_effect); gfx.with(lut, [&]() { ... });
+ */
+template <typename Format>
+template <typename F>
+LutEffect GfxBlendT<Format>::bake(const F& effect)
+{
+  return LutEffect::bake(effect);
+}
+
 // /**
 //  * Converts various function signatures into a standard blender_t.
 //  */
@@ -397,8 +1039,9 @@ void GfxBlend::add_effects_from_tuple_(Tpl&& tpl, std::index_sequence<I...>)
 //   }
 // }
 
+template <typename Format>
 template <typename F>
-void GfxBlend::add_step_internal_(F&& func)
+void GfxBlendT<Format>::add_step_internal_(F&& func)
 {
   using EffectDef = std::decay_t<F>;
   auto step = std::make_unique<GenericEffect<EffectDef>>(std::forward<F>(func));
@@ -421,7 +1064,8 @@ void GfxBlend::add_step_internal_(F&& func)
   this->pipeline_.push_back(std::move(step));
 }
 
-const char* GfxBlend::display_type_to_string_(uint8_t type)
+template <typename Format>
+const char* GfxBlendT<Format>::display_type_to_string_(uint8_t type)
 {
   static const char* const TYPES[] = {"NONE", "BINARY", "GRAYSCALE", "COLOR"};
   uint8_t index = static_cast<uint8_t>(type);
@@ -432,8 +1076,14 @@ const char* GfxBlend::display_type_to_string_(uint8_t type)
 }
 
 
+// Default canvas for RGB565 (big-endian) framebuffers
+using GfxBlend = GfxBlendT<pixel_format::RGB565BE>;
+
 }  // namespace gfx_blend
 
 using Gfx = gfx_blend::GfxBlend;
+using Gfx565LE = gfx_blend::GfxBlendT<gfx_blend::pixel_format::RGB565LE>;
+using Gfx888 = gfx_blend::GfxBlendT<gfx_blend::pixel_format::RGB888>;
+using GfxGray8 = gfx_blend::GfxBlendT<gfx_blend::pixel_format::Gray8>;
 
 }  // namespace esphome
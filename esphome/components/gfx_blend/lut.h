@@ -0,0 +1,157 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "defs.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * Lookup table effect produced by GfxBlend::bake().
+ *
+ * Holds either a full table with one result per RGB565 input (65,536 entries, 128 KB,
+ * preferably in PSRAM) or, if the baked effect is channel-separable, three small
+ * per-channel tables (128 entries) whose results are OR-ed together.
+ * Either way an arbitrarily expensive unary effect costs one (or three) loads per pixel.
+ */
+struct LutEffect {
+  static constexpr size_t FULL_SIZE = 65536;
+
+  struct ChannelTables {
+    uint16_t r[32];  // Red result, already in position (0xF800)
+    uint16_t g[64];  // Green result (0x07E0)
+    uint16_t b[32];  // Blue result (0x001F)
+  };
+
+  std::shared_ptr<const uint16_t> full;          // FULL_SIZE entries, or nullptr
+  std::shared_ptr<const ChannelTables> channels;  // Used if `full` is not set
+
+  bool is_valid() const { return this->full || this->channels; }
+  bool is_channel_separable() const { return !this->full && this->channels; }
+
+  inline uint16_t HOT apply(uint16_t c) const
+  {
+    if (this->full) return this->full.get()[c];
+    if (this->channels) {
+      const ChannelTables& t = *this->channels;
+      return t.r[c >> 11] | t.g[(c >> 5) & 0x3F] | t.b[c & 0x1F];
+    }
+    return c;
+  }
+
+  inline uint16_t HOT operator()(int16_t x, int16_t y, uint16_t fg, uint16_t bg) const { return this->apply(fg); }
+
+  // Span form: the table variant is selected once per span
+  inline void HOT span(int16_t x, int16_t y, uint16_t* fg, const uint16_t* bg, int n) const
+  {
+    if (this->full) {
+      const uint16_t* table = this->full.get();
+      for (int i = 0; i < n; i++) fg[i] = table[fg[i]];
+    } else if (this->channels) {
+      const ChannelTables& t = *this->channels;
+      for (int i = 0; i < n; i++) {
+        const uint16_t c = fg[i];
+        fg[i] = t.r[c >> 11] | t.g[(c >> 5) & 0x3F] | t.b[c & 0x1F];
+      }
+    }
+  }
+
+  /**
+   * Evaluates a unary effect for every RGB565 input and returns the resulting table effect.
+   *
+   * Accepted effects:
+   * - Callables taking only the color: uint16_t(uint16_t fg)
+   * - Effects declaring `static constexpr bool unary = true;` (e.g. color_matrix)
+   * - Any other blender (x, y, fg, bg): unary behaviour is detected by evaluating every input
+   *   at two different positions and backgrounds. Effects depending on x, y or bg are rejected.
+   *
+   * @return An invalid LutEffect (passes colors through) if the effect is not unary or memory is exhausted.
+   */
+  template <typename F>
+  static LutEffect bake(const F& effect)
+  {
+    static constexpr const char* const TAG = "gfx_blend.lut";
+    using EffectDef = std::decay_t<F>;
+
+    auto eval = [&effect](uint16_t c) -> uint16_t {
+      if constexpr (std::is_invocable_r_v<uint16_t, const F&, uint16_t>) {
+        return effect(c);
+      } else {
+        return effect(0, 0, c, 0);
+      }
+    };
+
+    constexpr bool known_unary = std::is_invocable_r_v<uint16_t, const F&, uint16_t> ||
+                                 requires { requires EffectDef::unary; };
+
+    // Candidate per-channel tables: every channel evaluated with the other two at zero
+    auto channels = std::make_shared<ChannelTables>();
+    for (uint16_t v = 0; v < 32; v++) {
+      channels->r[v] = eval(v << 11) & 0xF800;
+      channels->b[v] = eval(v) & 0x001F;
+    }
+    for (uint16_t v = 0; v < 64; v++) channels->g[v] = eval(v << 5) & 0x07E0;
+
+    // One pass over all inputs: check separability and (if needed) independence from x, y and bg
+    bool separable = true;
+    for (uint32_t c = 0; c < FULL_SIZE; c++) {
+      const uint16_t res = eval(c);
+
+      if constexpr (!known_unary) {
+        if (res != effect(97, 53, uint16_t(c), uint16_t(~c))) {
+          ESP_LOGE(TAG, "bake(): effect depends on position or background and cannot be baked");
+          return LutEffect{};
+        }
+      }
+
+      if (separable && res != (channels->r[c >> 11] | channels->g[(c >> 5) & 0x3F] | channels->b[c & 0x1F])) {
+        separable = false;
+        if (known_unary) break;  // Nothing else to verify
+      }
+    }
+
+    LutEffect lut;
+    if (separable) {
+      ESP_LOGD(TAG, "bake(): channel-separable effect, using per-channel tables (%u bytes)",
+               (unsigned) sizeof(ChannelTables));
+      lut.channels = std::move(channels);
+      return lut;
+    }
+
+    // Full table; RAMAllocator prefers PSRAM and falls back to internal RAM
+    RAMAllocator<uint16_t> allocator;
+    uint16_t* table = allocator.allocate(FULL_SIZE);
+    if (table == nullptr) {
+      ESP_LOGE(TAG, "bake(): could not allocate %u bytes for the lookup table", (unsigned) (FULL_SIZE * 2));
+      return LutEffect{};
+    }
+
+    for (uint32_t c = 0; c < FULL_SIZE; c++) table[c] = eval(c);
+
+    lut.full = std::shared_ptr<const uint16_t>(table, [](const uint16_t* p) {
+      RAMAllocator<uint16_t> allocator;
+      allocator.deallocate(const_cast<uint16_t*>(p), FULL_SIZE);
+    });
+    return lut;
+  }
+};
+
+}  // namespace gfx_blend
+}  // namespace esphome
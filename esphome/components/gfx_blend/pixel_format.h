@@ -0,0 +1,107 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+#include "esphome/components/display/display.h"
+
+#include <cstdint>
+
+#include "defs.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * Compile-time traits of framebuffer pixel formats.
+ *
+ * The effect pipeline always works on RGB565 colors; a format only defines how a framebuffer
+ * pixel is converted from and to that working color:
+ * - BYTES: size of one pixel in the framebuffer
+ * - DISPLAY_TYPE: display type the format belongs to (checked at construction)
+ * - load(p): framebuffer bytes -> RGB565
+ * - store(p, c): RGB565 -> framebuffer bytes
+ *
+ * GfxBlendT<Format> is instantiated per format, so all raw buffer loops are specialized at
+ * compile time and contain no format checks.
+ */
+namespace pixel_format {
+
+// RGB565, high byte first (ili9xxx, st7789v, ... with a 16-bit buffer)
+struct RGB565BE {
+  static constexpr const char* NAME = "RGB565 (big-endian)";
+  static constexpr int BYTES = 2;
+  static constexpr display::DisplayType DISPLAY_TYPE = display::DISPLAY_TYPE_COLOR;
+
+  static inline uint16_t HOT load(const uint8_t* p) { return (uint16_t(p[0]) << 8) | p[1]; }
+  static inline void HOT store(uint8_t* p, uint16_t c)
+  {
+    p[0] = c >> 8;
+    p[1] = c & 0xFF;
+  }
+};
+
+// RGB565, low byte first
+struct RGB565LE {
+  static constexpr const char* NAME = "RGB565 (little-endian)";
+  static constexpr int BYTES = 2;
+  static constexpr display::DisplayType DISPLAY_TYPE = display::DISPLAY_TYPE_COLOR;
+
+  static inline uint16_t HOT load(const uint8_t* p) { return p[0] | (uint16_t(p[1]) << 8); }
+  static inline void HOT store(uint8_t* p, uint16_t c)
+  {
+    p[0] = c & 0xFF;
+    p[1] = c >> 8;
+  }
+};
+
+// RGB888, bytes in R, G, B order. Channels are reduced to RGB565 for blending and expanded
+// with bit replication on the way back.
+struct RGB888 {
+  static constexpr const char* NAME = "RGB888";
+  static constexpr int BYTES = 3;
+  static constexpr display::DisplayType DISPLAY_TYPE = display::DISPLAY_TYPE_COLOR;
+
+  static inline uint16_t HOT load(const uint8_t* p)
+  {
+    return uint16_t(((p[0] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[2] >> 3));
+  }
+  static inline void HOT store(uint8_t* p, uint16_t c)
+  {
+    const uint8_t r5 = c >> 11, g6 = (c >> 5) & 0x3F, b5 = c & 0x1F;
+    p[0] = (r5 << 3) | (r5 >> 2);
+    p[1] = (g6 << 2) | (g6 >> 4);
+    p[2] = (b5 << 3) | (b5 >> 2);
+  }
+};
+
+// 8-bit grayscale. Loaded as a gray RGB565 color, stored as its luminance (ITU-R BT.709).
+struct Gray8 {
+  static constexpr const char* NAME = "Grayscale (8 bit)";
+  static constexpr int BYTES = 1;
+  static constexpr display::DisplayType DISPLAY_TYPE = display::DISPLAY_TYPE_GRAYSCALE;
+
+  static inline uint16_t HOT load(const uint8_t* p)
+  {
+    const uint8_t v = p[0];
+    return uint16_t(((v >> 3) << 11) | ((v >> 2) << 5) | (v >> 3));
+  }
+  static inline void HOT store(uint8_t* p, uint16_t c)
+  {
+    const uint32_t r5 = c >> 11, g6 = (c >> 5) & 0x3F, b5 = c & 0x1F;
+    const uint32_t r = (r5 << 3) | (r5 >> 2), g = (g6 << 2) | (g6 >> 4), b = (b5 << 3) | (b5 >> 2);
+    p[0] = uint8_t((r * 54 + g * 183 + b * 19) >> 8);
+  }
+};
+
+}  // namespace pixel_format
+}  // namespace gfx_blend
+}  // namespace esphome
@@ -7,7 +7,7 @@
  * 
  * @author fschroedter
  * @copyright MIT License
- * @note This library requires a 16-bit color display (RGB565).
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
  */
 
 #pragma once
@@ -29,14 +29,15 @@ namespace gfx_blend {
 template <typename TBlender>
 class GfxProxy : public esphome::display::DisplayBuffer {
 public:
-  GfxProxy(esphome::display::DisplayBuffer* real_display, TBlender b)
-      : real_display_(real_display), blender_(std::move(b))
+  GfxProxy(esphome::display::DisplayBuffer* real_display, TBlender b, ClipRect clip)
+      : real_display_(real_display), blender_(std::move(b)), clip_(clip)
   {
   }
 
   inline void HOT draw_pixel_at(int x, int y, esphome::Color color) override;
   inline void HOT horizontal_line(int x, int y, int width, esphome::Color color);
   inline void HOT vertical_line(int x, int y, int height, esphome::Color color);
+  inline void HOT filled_rectangle(int x, int y, int width, int height, esphome::Color color);
   inline int HOT get_width_internal() override;
   inline int HOT get_height_internal() override;
   esphome::display::DisplayType get_display_type() override;
@@ -58,6 +59,9 @@ protected:
    * can be executed sequentially.
    */
   TBlender blender_;
+
+  // Visible area (display intersected with the canvas clip); every write is limited to it
+  ClipRect clip_;
 };
 
 /**
@@ -67,6 +71,9 @@ protected:
 template <typename TBlender>
 inline void HOT GfxProxy<TBlender>::draw_pixel_at(int x, int y, esphome::Color color)
 {
+  // Outside of the clip (or the display): skip before touching the framebuffer
+  if (!this->clip_.contains(x, y)) return;
+
   // Read the color from the actual display (background)
   uint16_t fg = display::ColorUtil::color_to_565(color, display::ColorOrder::COLOR_ORDER_RGB);
 
@@ -74,17 +81,40 @@ inline void HOT GfxProxy<TBlender>::draw_pixel_at(int x, int y, esphome::Color c
   uint16_t final_color = this->blender_(x, y, fg);
 
   // Write back
-  this->real_display_->draw_pixel_at(x, y, rgb565_to_color(final_color));
+  this->blender_.put(x, y, final_color);
 }
 
 /**
  * Horizontal line redirector
- * Prevent horizontal lines from being processed pixel by pixel over the slow standard base class
+ * Prevent horizontal lines from being processed pixel by pixel over the slow standard base class.
+ * If the blender supports spans, the line is clipped once and processed in chunks of SPAN_CHUNK pixels.
  */
 template <typename TBlender>
 inline void HOT GfxProxy<TBlender>::horizontal_line(int x, int y, int width, esphome::Color color)
 {
-  for (int i = 0; i < width; i++) draw_pixel_at(x + i, y, color);
+  if constexpr (requires(uint16_t* out) { this->blender_.span(int16_t(x), int16_t(y), uint16_t(0), out, width); }) {
+    // Clip once per span (draw_pixel_at would do this per pixel)
+    if (y < this->clip_.y || y >= this->clip_.y + this->clip_.h) return;
+    if (x < this->clip_.x) {
+      width -= this->clip_.x - x;
+      x = this->clip_.x;
+    }
+    const int max_w = this->clip_.x + this->clip_.w - x;
+    if (width > max_w) width = max_w;
+
+    const uint16_t fg = display::ColorUtil::color_to_565(color, display::ColorOrder::COLOR_ORDER_RGB);
+    uint16_t out[SPAN_CHUNK];
+
+    for (int start = 0; start < width; start += SPAN_CHUNK) {
+      const int n = (width - start < SPAN_CHUNK) ? width - start : SPAN_CHUNK;
+      this->blender_.span(x + start, y, fg, out, n);
+
+      FRAME_PROFILER_SCOPE(WRITE);
+      for (int i = 0; i < n; i++) this->blender_.put(x + start + i, y, out[i]);
+    }
+  } else {
+    for (int i = 0; i < width; i++) draw_pixel_at(x + i, y, color);
+  }
 }
 
 /**
@@ -94,9 +124,46 @@ inline void HOT GfxProxy<TBlender>::horizontal_line(int x, int y, int width, esp
 template <typename TBlender>
 inline void HOT GfxProxy<TBlender>::vertical_line(int x, int y, int height, esphome::Color color)
 {
+  if (!this->clip_.intersects(x, y, 1, height)) return;
   for (int i = 0; i < height; i++) draw_pixel_at(x, y + i, color);
 }
 
+/**
+ * Filled rectangle redirector
+ * Hides the base class implementation so that rectangles drawn through the proxy
+ * (directly or by the GfxShapes algorithms) are clipped once and processed as horizontal spans,
+ * or as tiles on displays rotated by 90/270 degrees.
+ */
+template <typename TBlender>
+inline void HOT GfxProxy<TBlender>::filled_rectangle(int x, int y, int width, int height, esphome::Color color)
+{
+  // Rotated output (90/270 degrees): render logical tiles and transfer them as blocks
+  const ClipRect visible = this->clip_.intersect(x, y, width, height);
+  if (visible.w <= 0 || visible.h <= 0) return;
+  x = visible.x;
+  y = visible.y;
+  width = visible.w;
+  height = visible.h;
+
+  if constexpr (requires { this->blender_.tile(int16_t(x), int16_t(y), width, height, uint16_t(0)); }) {
+    if (height > 1 && this->blender_.prefers_tiles()) {
+
+      const uint16_t fg = display::ColorUtil::color_to_565(color, display::ColorOrder::COLOR_ORDER_RGB);
+      for (int ty = 0; ty < height; ty += TILE_SIZE) {
+        const int th = (height - ty < TILE_SIZE) ? height - ty : TILE_SIZE;
+        for (int tx = 0; tx < width; tx += TILE_SIZE) {
+          const int tw = (width - tx < TILE_SIZE) ? width - tx : TILE_SIZE;
+          this->blender_.tile(x + tx, y + ty, tw, th, fg);
+        }
+      }
+      this->blender_.mark_dirty(x, y, width, height);
+      return;
+    }
+  }
+
+  for (int i = 0; i < height; i++) this->horizontal_line(x, y + i, width, color);
+}
+
 // Delegate essential display properties to the real display
 template <typename TBlender>
 esphome::display::DisplayType GfxProxy<TBlender>::get_display_type()
@@ -0,0 +1,157 @@
+/**
+ * Graphics extension for rendering blended shapes on ESPHome displays.
+ *
+ * @brief This library extends ESPHome's native display capabilities with support for
+ * alpha blending (transparency), image masking, and advanced geometric primitives
+ * including rounded rectangles, ellipses, and color gradients.
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
+ */
+
+#pragma once
+#include "esphome/core/color.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "blur.h"
+
+namespace esphome {
+namespace gfx_blend {
+
+/**
+ * Style of a drop shadow.
+ * Usage: gfx.filled_rectangle(x, y, w, h, r, Color(255, 255, 255), Shadow{4, Color(0, 0, 0), 2, 3, 160});
+ */
+struct Shadow {
+  uint8_t blur{4};                // Blur radius; the shadow grows by 3 * blur on every side
+  esphome::Color color{0, 0, 0};  // Shadow color
+  int16_t offset_x{0};            // Horizontal offset relative to the shape
+  int16_t offset_y{2};            // Vertical offset relative to the shape
+  uint8_t opacity{128};           // Global opacity (0-255)
+};
+
+/**
+ * Blurred coverage mask of a rounded rectangle.
+ * The mask is larger than the rectangle by `margin` on every side.
+ */
+struct ShadowProfile {
+  int16_t w{0};
+  int16_t h{0};
+  int16_t r{0};
+  uint8_t blur{0};
+  int16_t margin{0};
+  uint32_t last_used{0};
+  std::vector<uint8_t> alpha;  // (w + 2 * margin) * (h + 2 * margin) values, row-major
+
+  int stride() const { return this->w + 2 * this->margin; }
+  int rows() const { return this->h + 2 * this->margin; }
+  bool matches(int w, int h, int r, uint8_t blur) const
+  {
+    return !this->alpha.empty() && this->w == w && this->h == h && this->r == r && this->blur == blur;
+  }
+};
+
+/**
+ * Small LRU cache of shadow profiles keyed by (w, h, r, blur).
+ * Cards on a dashboard usually share few shapes, so a handful of entries is enough and
+ * the expensive mask generation runs once instead of every frame.
+ */
+class ShadowCache {
+public:
+  static constexpr uint8_t CAPACITY = 4;
+
+  const ShadowProfile& get(int w, int h, int r, uint8_t blur)
+  {
+    this->tick_++;
+
+    // Radii beyond the pill shape draw the same mask, so they must share its entry
+    const int max_r = (w < h ? w : h) >> 1;
+    if (r > max_r) r = max_r;
+    if (r < 0) r = 0;
+
+    for (auto& entry : this->entries_) {
+      if (entry.matches(w, h, r, blur)) {
+        entry.last_used = this->tick_;
+        this->hits_++;
+        return entry;
+      }
+    }
+
+    // Miss: replace the least recently used (or an empty) entry
+    ShadowProfile* victim = &this->entries_[0];
+    for (auto& entry : this->entries_) {
+      if (entry.last_used < victim->last_used) victim = &entry;
+    }
+
+    this->misses_++;
+    generate_(*victim, w, h, r, blur);
+    victim->last_used = this->tick_;
+    return *victim;
+  }
+
+  uint32_t get_hits() const { return this->hits_; }
+  uint32_t get_misses() const { return this->misses_; }
+  void clear() { this->entries_ = {}; }
+
+protected:
+  std::array<ShadowProfile, CAPACITY> entries_{};
+  uint32_t tick_{0};
+  uint32_t hits_{0};
+  uint32_t misses_{0};
+
+  /**
+   * Rasterizes the rounded rectangle as a binary mask and blurs it (rows, then columns).
+   * `r` is already clamped to [0, min(w, h) / 2] by get().
+   */
+  static void generate_(ShadowProfile& p, int w, int h, int r, uint8_t blur)
+  {
+    p.w = w;
+    p.h = h;
+    p.r = r;
+    p.blur = blur;
+    p.margin = 3 * blur;  // Three box passes spread the edge by 3 * radius
+
+    const int stride = p.stride();
+    const int rows = p.rows();
+    p.alpha.assign(stride * rows, 0);
+
+    // Same corner test as filled_round_rectangle()
+    const int r2 = r * r;
+    for (int dy = 0; dy < h; dy++) {
+      uint8_t* row = &p.alpha[(dy + p.margin) * stride + p.margin];
+      int inset = 0;
+      if (dy < r || dy >= h - r) {
+        const int dy_dist = dy < r ? r - dy - 1 : dy - (h - r);
+        inset = r;
+        for (int dx = 0; dx < r; dx++) {
+          const int dx_dist = r - dx - 1;
+          if (dx_dist * dx_dist + dy_dist * dy_dist <= r2) {
+            inset = dx;
+            break;
+          }
+        }
+      }
+      for (int dx = inset; dx < w - inset; dx++) row[dx] = 255;
+    }
+
+    if (blur == 0) return;
+
+    BoxBlur box(blur);
+    std::vector<uint8_t> column(rows);
+
+    for (int y = 0; y < rows; y++) box.blur_line(&p.alpha[y * stride], stride);
+
+    for (int x = 0; x < stride; x++) {
+      for (int y = 0; y < rows; y++) column[y] = p.alpha[y * stride + x];
+      box.blur_line(column.data(), rows);
+      for (int y = 0; y < rows; y++) p.alpha[y * stride + x] = column[y];
+    }
+  }
+};
+
+}  // namespace gfx_blend
+}  // namespace esphome
@@ -7,7 +7,7 @@
  * 
  * @author fschroedter
  * @copyright MIT License
- * @note This library requires a 16-bit color display (RGB565).
+ * @note Blending works on RGB565 colors; RGB565 (BE/LE), RGB888 and 8-bit grayscale framebuffers are supported.
  */
 
 #pragma once
@@ -15,6 +15,12 @@
 
 #include "esphome/components/display/display_buffer.h"
 
+#include <algorithm>
+
+#include "accessor.h"
+#include "defs.h"
+#include "shadow.h"
+
 namespace esphome {
 namespace gfx_blend {
 
@@ -25,6 +31,114 @@ class GfxProxy;
 
 enum GradientDirection { GRADIENT_HORIZONTAL, GRADIENT_VERTICAL };
 
+/**
+ * Pixel processor handed to GfxProxy while a pipeline is active.
+ * Reads the background (if any effect needs it) and runs the canvas pipeline,
+ * either for a single pixel or for a horizontal span.
+ * @tparam TCanvas The canvas class (GfxBlend).
+ */
+template <typename TCanvas>
+struct PipelineBlender {
+  TCanvas& canvas;
+
+  inline uint16_t HOT operator()(int16_t x, int16_t y, uint16_t fg) const
+  {
+    // 1. Optimized background read: skip if no effect in the pipeline needs it
+    uint16_t bg = 0;
+    if (this->canvas.bg_read_enabled()) {
+      bg = this->canvas.read_raw_pixel_from_buffer_(x, y);
+
+      if (this->canvas.bg_as_source_enabled()) {
+        fg = bg;
+      }
+    }
+
+    // 2. Process through the effect chain
+    return this->canvas.apply_pipeline(x, y, fg, bg);
+  }
+
+  /**
+   * Blends a solid color over `n` pixels (n <= SPAN_CHUNK) starting at (x, y).
+   * @param out Receives the final colors.
+   */
+  inline void HOT span(int16_t x, int16_t y, uint16_t fg, uint16_t* out, int n) const
+  {
+    uint16_t bg[SPAN_CHUNK];
+
+    if (this->canvas.bg_read_enabled()) {
+      const bool bg_as_source = this->canvas.bg_as_source_enabled();
+      for (int i = 0; i < n; i++) {
+        bg[i] = this->canvas.read_raw_pixel_from_buffer_(x + i, y);
+        out[i] = bg_as_source ? bg[i] : fg;
+      }
+    } else {
+      for (int i = 0; i < n; i++) {
+        bg[i] = 0;
+        out[i] = fg;
+      }
+    }
+
+    this->canvas.apply_pipeline_span(x, y, out, bg, n);
+  }
+
+  /**
+   * True if rectangles should be rendered in tiles (raw buffer available and the display is
+   * rotated by 90 or 270 degrees, where row-wise writes hit one native column per pixel).
+   */
+  inline bool prefers_tiles() const
+  {
+    return DisplayBufferAccessor::get_raw_buffer(this->canvas.disp_) != nullptr && this->canvas.is_transposed_();
+  }
+
+  /**
+   * Blends a solid color over a logical tile (w, h <= TILE_SIZE) and writes it straight into the
+   * framebuffer. The tile is rendered row-wise in logical orientation and transferred as a block.
+   */
+  inline void HOT tile(int16_t x, int16_t y, int w, int h, uint16_t fg) const
+  {
+    uint16_t bg[TILE_SIZE * TILE_SIZE];
+    uint16_t out[TILE_SIZE * TILE_SIZE];
+    const int count = TILE_SIZE * h;
+
+    if (this->canvas.bg_read_enabled()) {
+      this->canvas.read_raw_block_(x, y, w, h, bg, TILE_SIZE);
+      if (this->canvas.bg_as_source_enabled()) {
+        std::copy(bg, bg + count, out);
+      } else {
+        std::fill(out, out + count, fg);
+      }
+    } else {
+      std::fill(bg, bg + count, 0);
+      std::fill(out, out + count, fg);
+    }
+
+    for (int row = 0; row < h; row++) {
+      this->canvas.apply_pipeline_span(x, y + row, out + row * TILE_SIZE, bg + row * TILE_SIZE, w);
+    }
+    this->canvas.write_raw_block_(x, y, w, h, out, TILE_SIZE);
+  }
+
+  // Writes a final color (through the display driver, or raw on band workers)
+  inline void HOT put(int x, int y, uint16_t color) const { this->canvas.put_pixel_(x, y, color); }
+
+  // Reports a region written through tile() to the display driver
+  inline void mark_dirty(int x, int y, int w, int h) const { this->canvas.mark_region_dirty_(x, y, w, h); }
+};
+
+/**
+ * Pixel processor used while the pipeline is empty but a clip rectangle is active.
+ * Colors pass through unchanged; the proxy only applies the clipping.
+ * @tparam TCanvas The canvas class (GfxBlend).
+ */
+template <typename TCanvas>
+struct PassThroughBlender {
+  TCanvas& canvas;
+
+  inline uint16_t HOT operator()(int16_t x, int16_t y, uint16_t fg) const { return fg; }
+  inline void HOT span(int16_t x, int16_t y, uint16_t fg, uint16_t* out, int n) const { std::fill(out, out + n, fg); }
+  inline void HOT put(int x, int y, uint16_t color) const { this->canvas.put_pixel_(x, y, color); }
+};
+
 /**
  * Mix-in class containing drawing algorithms.
  * T is the class that actually implements draw_blend_pixel_at (the Canvas).
@@ -39,6 +153,7 @@ public:
 
   T& filled_rectangle(int x, int y, int w, int h, esphome::Color c)
   {
+    if (this->culled_(x, y, w, h)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       it.filled_rectangle(x, y, w, h, c);
     });
@@ -47,6 +162,7 @@ public:
   // Standard Circle
   T& filled_circle(int x, int y, int radius, esphome::Color c)
   {
+    if (this->culled_(x - radius, y - radius, 2 * radius + 1, 2 * radius + 1)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       it.filled_circle(x, y, radius, c);
     });
@@ -54,6 +170,8 @@ public:
 
   T& filled_ring(int center_x, int center_y, int radius1, int radius2, esphome::Color c)
   {
+    const int outer = std::max(radius1, radius2);
+    if (this->culled_(center_x - outer, center_y - outer, 2 * outer + 1, 2 * outer + 1)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       it.filled_ring(center_x, center_y, radius1, radius2, c);
     });
@@ -61,6 +179,9 @@ public:
 
   T& filled_triangle(int x1, int y1, int x2, int y2, int x3, int y3, esphome::Color c)
   {
+    const int min_x = std::min({x1, x2, x3}), min_y = std::min({y1, y2, y3});
+    const int max_x = std::max({x1, x2, x3}), max_y = std::max({y1, y2, y3});
+    if (this->culled_(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       it.filled_triangle(x1, y1, x2, y2, x3, y3, c);
     });
@@ -82,14 +203,23 @@ public:
   // Rounded Rectangle(Overload by adding r)
   T& filled_rectangle(int x, int y, int w, int h, int r, esphome::Color c)
   {
+    if (this->culled_(x, y, w, h)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       this->filled_round_rectangle(it, x, y, w, h, r, c);
     });
   }
 
+  // Rounded Rectangle with drop shadow (Overload by adding a Shadow)
+  T& filled_rectangle(int x, int y, int w, int h, int r, esphome::Color c, const Shadow& shadow)
+  {
+    this->drop_shadow(x, y, w, h, r, shadow);
+    return this->filled_rectangle(x, y, w, h, r, c);
+  }
+
   // Gradient Rectangle (Overload by adding second color and direction)
   T& filled_rectangle(int x, int y, int w, int h, esphome::Color c1, esphome::Color c2, GradientDirection dir)
   {
+    if (this->culled_(x, y, w, h)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       this->filled_rectangle_gradient(it, x, y, w, h, c1, c2, dir);
     });
@@ -99,17 +229,27 @@ public:
   T& filled_rectangle(int x, int y, int w, int h, int r, esphome::Color c1, esphome::Color c2,
                       GradientDirection dir = GRADIENT_HORIZONTAL)
   {
+    if (this->culled_(x, y, w, h)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       filled_round_rectangle_gradient(it, x, y, w, h, r, c1, c2, dir);
     });
   }
 
+  // --- Shadow -------------------------------------------------
+  // Soft shadow of a rounded rectangle; the blurred profile is cached per (w, h, r, blur)
+  T& drop_shadow(int x, int y, int w, int h, int r, const Shadow& shadow)
+  {
+    static_cast<T&>(*this).draw_shadow_(x, y, w, h, r, shadow);
+    return static_cast<T&>(*this);
+  }
+
   // --- Circle / Ellipse ---------------------------------------
 
   // Reuse ellipse gradient logic with equal radii for a perfect circle
   T& filled_circle(int x, int y, int radius, esphome::Color c1, esphome::Color c2,
                    GradientDirection dir = GRADIENT_HORIZONTAL)
   {
+    if (this->culled_(x - radius, y - radius, 2 * radius + 1, 2 * radius + 1)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       filled_ellipse_gradient(it, x, y, radius, radius, c1, c2, dir);
     });
@@ -118,6 +258,7 @@ public:
   // Ellipse (Overload by providing rx and ry instead of a single radius)
   T& filled_circle(int x, int y, int rx, int ry, esphome::Color c)
   {
+    if (this->culled_(x - rx, y - ry, 2 * rx + 1, 2 * ry + 1)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       filled_ellipse(it, x, y, rx, ry, c);
     });
@@ -127,6 +268,7 @@ public:
   T& filled_circle(int x, int y, int rx, int ry, esphome::Color c1, esphome::Color c2,
                    GradientDirection dir = GRADIENT_HORIZONTAL)
   {
+    if (this->culled_(x - rx, y - ry, 2 * rx + 1, 2 * ry + 1)) return static_cast<T&>(*this);
     return static_cast<T&>(*this).draw_generic([&](auto& it) {  //
       filled_ellipse_gradient(it, x, y, rx, ry, c1, c2, dir);
     });
@@ -302,9 +444,13 @@ public:
   }
 
 protected:
+  // Early rejection before any rasterization: true if the bounding box lies outside the clip
+  bool culled_(int x, int y, int w, int h) { return !static_cast<T&>(*this).get_clip().intersects(x, y, w, h); }
+
   /**
    * @brief Executes a draw call, optionally routing it through a blending proxy.
-   * If the pipeline is empty, the draw function executes directly on the display.
+   * If the pipeline is empty and no clip is set, the draw function executes directly on the display.
+   * With a clip rectangle but no effects, a pass-through proxy only limits the writes.
    * If effects are active, a stack-allocated proxy intercepts pixel writes to
    * apply the filter chain via template-based inlining for maximum performance.
    * @tparam F Type of the drawing lambda.
@@ -329,29 +475,19 @@ protected:
       }
     };
 
-    if (self.get_pipeline().empty()) {
+    if (self.get_pipeline().empty() && !self.has_clip()) {
       // QUICKPATH: Direct rendering to the real display
       execute(self.get_real_display());
+    } else if (self.get_pipeline().empty()) {
+      // CLIPPATH: No effects, but writes must be limited to the clip rectangle
+      GfxProxy<PassThroughBlender<T>> proxy(self.get_real_display(), PassThroughBlender<T>{self}, self.get_clip());
+      execute(&proxy);
     } else {
-      // BLENDPATH: Create the pixel-processing lambda
-      auto pipeline_blender = [&self](int16_t x, int16_t y, uint16_t fg) -> uint16_t {
-        // 1. Optimized background read: skip if no effect in the pipeline needs it
-
-        uint16_t bg = 0;
-        if (self.bg_read_enabled()) {
-          bg = self.read_raw_pixel_from_buffer_(x, y);
-
-          if (self.bg_as_source_enabled()) {
-            fg = bg;
-          }
-        }
-
-        // 2. Process through the effect chain
-        return self.apply_pipeline(x, y, fg, bg);
-      };
+      // BLENDPATH: Create the pixel-processing blender
+      PipelineBlender<T> pipeline_blender{self};
 
       // Create the proxy on the stack with the specialized blender type
-      GfxProxy<decltype(pipeline_blender)> proxy(self.get_real_display(), pipeline_blender);
+      GfxProxy<PipelineBlender<T>> proxy(self.get_real_display(), pipeline_blender, self.get_clip());
 
       // Run the user's draw commands through the proxy
       execute(&proxy);
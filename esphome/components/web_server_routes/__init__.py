@@ -1,3 +1,6 @@
+import math
+import re
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.const import CONF_ID, CONF_LAMBDA
@@ -8,6 +11,8 @@ DEPENDENCIES = ["web_server_base"]
 web_server_routes_ns = cg.esphome_ns.namespace("web_server_routes")
 WebServerRoutes = web_server_routes_ns.class_("WebServerRoutes", cg.Component)
 RouteEntry = WebServerRoutes.class_("RouteEntry")
+RouteContext = web_server_routes_ns.class_("RouteContext")
+StaticHeader = web_server_routes_ns.struct("StaticHeader")
 
 CONF_ROUTES = "routes"
 CONF_PATH = "path"
@@ -20,6 +25,22 @@ CONF_HEADER_CONTENT_TYPE = "content_type"
 CONF_HEADER_CONTENT_DISPOSITION = "content_disposition"
 CONF_HEADER_CACHE_CONTROL = "cache_control"
 CONF_HEADER_CONNECTION = "connection"
+CONF_SEND_TIMEOUT = "send_timeout"
+CONF_STATIC_HEADERS_ID = "static_headers_id"
+CONF_GZIP = "gzip"
+CONF_GZIP_WINDOW = "gzip_window"
+CONF_CACHE_TTL = "cache_ttl"
+CONF_CACHE_SIZE = "cache_size"
+CONF_RATE_LIMIT = "rate_limit"
+CONF_RATE = "rate"
+CONF_BURST = "burst"
+CONF_MAX_CONCURRENT = "max_concurrent"
+CONF_KEEP_ALIVE = "keep_alive"
+CONF_IDLE_TIMEOUT = "idle_timeout"
+CONF_MAX_CONNECTIONS = "max_connections"
+
+# RFC 9110 field name (token)
+HEADER_FIELD_RE = re.compile(r"^[!#$%&'*+\-.^_`|~0-9A-Za-z]+$")
 
 
 def normalize_path(path: str) -> str:
@@ -28,16 +49,85 @@ def normalize_path(path: str) -> str:
     return "/" + path.strip("/")
 
 
+def header_value(value):
+    value = cv.string(value).strip()
+    if any(ord(c) < 0x20 and c != "\t" or ord(c) == 0x7F for c in value):
+        raise cv.Invalid(f"Header value '{value}' contains control characters")
+    return value
+
+
+def header_string(value):
+    """Validates a raw header of the form 'Field: value'."""
+    value = cv.string(value)
+    field, sep, content = value.partition(":")
+    field = field.strip()
+    if not sep or not HEADER_FIELD_RE.match(field):
+        raise cv.Invalid(f"Invalid header '{value}', expected 'Field: value'")
+    return f"{field}: {header_value(content)}"
+
+
+def build_headers(route):
+    """Final headers of a route: options first, then `headers` (overriding by field name).
+    Fields are compared case-insensitively; headers with empty values are dropped."""
+    headers = {}
+
+    def set_header(field, value):
+        key = field.lower()
+        if key in headers:
+            field = headers[key][0]  # Keep position and spelling of the first occurrence
+        headers[key] = (field, value)
+
+    disposition = ""
+    if CONF_FILENAME in route:
+        disposition = f'attachment; filename="{route[CONF_FILENAME]}"'
+    elif CONF_HEADER_CONTENT_DISPOSITION in route:
+        disposition = route[CONF_HEADER_CONTENT_DISPOSITION]
+
+    set_header("Cache-Control", route.get(CONF_HEADER_CACHE_CONTROL, ""))
+    set_header("Connection", route.get(CONF_HEADER_CONNECTION, ""))
+    set_header("Content-Type", route.get(CONF_HEADER_CONTENT_TYPE, ""))
+    set_header("Content-Disposition", disposition)
+
+    for header in route.get(CONF_HEADERS, []):
+        field, _, value = header.partition(":")
+        set_header(field.strip(), value.strip())
+
+    return [(field, value) for field, value in headers.values() if value]
+
+
+def _default_burst(config):
+    if CONF_BURST not in config:
+        config[CONF_BURST] = max(1, math.ceil(config[CONF_RATE]))
+    return config
+
+
+RATE_LIMIT_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            # Requests per second on average
+            cv.Required(CONF_RATE): cv.float_range(min=0.01, max=1000),
+            # Requests accepted at once after an idle period, default: one second worth
+            cv.Optional(CONF_BURST): cv.int_range(min=1, max=1000),
+        }
+    ),
+    _default_burst,
+)
+
+
 def _validate_routes(config):
     # Get the global fallback/prefix path
     routes = config.get(CONF_ROUTES, [])
     global_path = config.get(CONF_PATH)
 
+    # Without keep-alive mode routes close the connection; with it the component decides
+    connection = "" if CONF_KEEP_ALIVE in config else "close"
+
     seen = set()
     for route in routes:
 
         if CONF_PATH not in route:
             route[CONF_PATH] = global_path
+        route.setdefault(CONF_HEADER_CONNECTION, connection)
 
         key = route.get(CONF_QUERY_KEY, "")
         path = normalize_path(route[CONF_PATH])
@@ -58,22 +148,43 @@ def _validate_routes(config):
 ROUTE_SCHEMA = cv.Schema(
     {
         cv.GenerateID(CONF_ID): cv.declare_id(RouteEntry),
+        cv.GenerateID(CONF_STATIC_HEADERS_ID): cv.declare_id(StaticHeader),
         cv.Optional(CONF_LAMBDA): cv.lambda_,
         cv.Optional(CONF_PATH): cv.string,
         cv.Optional(
             CONF_HEADERS,
             default=[
                 "Cache-Control: no-cache",
-                "Connection: close",
             ],
-        ): cv.ensure_list(cv.string),
+        ): cv.ensure_list(header_string),
         cv.Optional(CONF_UNIQUE_HEADER_FIELDS, default=True): cv.boolean,
         cv.Optional(CONF_QUERY_KEY, default=""): cv.string,
-        cv.Optional(CONF_HEADER_CACHE_CONTROL, default="no-cache"): cv.string,
-        cv.Optional(CONF_HEADER_CONNECTION, default="close"): cv.string,
-        cv.Optional(CONF_HEADER_CONTENT_TYPE, default=""): cv.string,
-        cv.Exclusive(CONF_HEADER_CONTENT_DISPOSITION, "disposition"): cv.string,
-        cv.Exclusive(CONF_FILENAME, "disposition"): cv.string,
+        cv.Optional(
+            CONF_SEND_TIMEOUT, default="2s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_CACHE_TTL): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_RATE_LIMIT): RATE_LIMIT_SCHEMA,
+        cv.Optional(CONF_MAX_CONCURRENT): cv.int_range(min=1, max=16),
+        cv.Optional(CONF_GZIP, default=False): cv.boolean,
+        cv.Optional(CONF_GZIP_WINDOW, default=1024): cv.one_of(
+            512, 1024, 2048, 4096, 8192, int=True
+        ),
+        cv.Optional(CONF_HEADER_CACHE_CONTROL, default="no-cache"): header_value,
+        cv.Optional(CONF_HEADER_CONNECTION): header_value,
+        cv.Optional(CONF_HEADER_CONTENT_TYPE, default=""): header_value,
+        cv.Exclusive(CONF_HEADER_CONTENT_DISPOSITION, "disposition"): header_value,
+        cv.Exclusive(CONF_FILENAME, "disposition"): header_value,
+    }
+)
+
+KEEP_ALIVE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_IDLE_TIMEOUT, default="5s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=1), max=cv.TimePeriod(seconds=60)),
+        ),
+        # Keep below httpd's max_open_sockets, so new connections always find a free socket
+        cv.Optional(CONF_MAX_CONNECTIONS, default=4): cv.int_range(min=1, max=8),
     }
 )
 
@@ -85,6 +196,9 @@ CONFIG_SCHEMA = cv.All(
                 web_server_base.WebServerBase
             ),
             cv.Optional(CONF_PATH, default="download"): cv.string,
+            cv.Optional(CONF_CACHE_SIZE, default=16384): cv.int_range(min=1024),
+            cv.Optional(CONF_RATE_LIMIT): RATE_LIMIT_SCHEMA,
+            cv.Optional(CONF_KEEP_ALIVE): KEEP_ALIVE_SCHEMA,
             cv.Required(CONF_ROUTES): cv.ensure_list(ROUTE_SCHEMA),
         }
     ).extend(cv.COMPONENT_SCHEMA),
@@ -98,6 +212,17 @@ async def to_code(config):
 
     base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
     cg.add(var.set_web_server_base(base))
+    cg.add(var.set_cache_size(config[CONF_CACHE_SIZE]))
+    if CONF_RATE_LIMIT in config:
+        limit = config[CONF_RATE_LIMIT]
+        cg.add(var.set_rate_limit(limit[CONF_RATE], limit[CONF_BURST]))
+    if CONF_KEEP_ALIVE in config:
+        keep_alive = config[CONF_KEEP_ALIVE]
+        cg.add(
+            var.set_keep_alive(
+                keep_alive[CONF_IDLE_TIMEOUT], keep_alive[CONF_MAX_CONNECTIONS]
+            )
+        )
 
     # Sort routes to ensure specific keys are matched before generic empty-key
     config[CONF_ROUTES].sort(key=lambda x: (x.get(CONF_QUERY_KEY, "") == "",))
@@ -116,7 +241,7 @@ async def to_code(config):
         if CONF_LAMBDA in route_conf:
             lambda_code = await cg.process_lambda(
                 route_conf[CONF_LAMBDA],
-                [(WebServerRoutes.operator("ref"), "it")],
+                [(RouteContext.operator("ref"), "it")],
                 return_type=cg.void,
             )
 
@@ -128,24 +253,26 @@ async def to_code(config):
             lambda_code,
         )
 
-        header_cache_controle = route_conf.get(CONF_HEADER_CACHE_CONTROL, "")
-        header_connection = route_conf.get(CONF_HEADER_CONNECTION, "")
-        header_content_type = route_conf.get(CONF_HEADER_CONTENT_TYPE, "")
+        cg.add(var.add_route(route_var))
+        cg.add(route_var.set_send_timeout(route_conf[CONF_SEND_TIMEOUT]))
+        if CONF_CACHE_TTL in route_conf:
+            cg.add(route_var.set_cache_ttl(route_conf[CONF_CACHE_TTL]))
+        if CONF_RATE_LIMIT in route_conf:
+            limit = route_conf[CONF_RATE_LIMIT]
+            cg.add(route_var.set_rate_limit(limit[CONF_RATE], limit[CONF_BURST]))
+        if CONF_MAX_CONCURRENT in route_conf:
+            cg.add(route_var.set_max_concurrent(route_conf[CONF_MAX_CONCURRENT]))
+        if route_conf[CONF_GZIP]:
+            cg.add(route_var.set_gzip_window(route_conf[CONF_GZIP_WINDOW]))
 
-        header_content_disposition = ""
-        if CONF_FILENAME in route_conf:
-            header_content_disposition = (
-                f'attachment; filename="{route_conf[CONF_FILENAME]}"'
+        # Headers are resolved here and end up as string literals in flash
+        headers = build_headers(route_conf)
+        if headers:
+            static_headers = cg.static_const_array(
+                route_conf[CONF_STATIC_HEADERS_ID],
+                cg.ArrayInitializer(
+                    *[cg.ArrayInitializer(field, value) for field, value in headers],
+                    multiline=True,
+                ),
             )
-        elif CONF_HEADER_CONTENT_DISPOSITION in route_conf:
-            header_content_disposition = route_conf[CONF_HEADER_CONTENT_DISPOSITION]
-
-        cg.add(var.add_route(route_var))
-        cg.add(route_var.add_header("Cache-Control", header_cache_controle))
-        cg.add(route_var.add_header("Connection", header_connection))
-        cg.add(route_var.add_header("Content-Type", header_content_type))
-        cg.add(route_var.add_header("Content-Disposition", header_content_disposition))
-
-        if CONF_HEADERS in route_conf:
-            for header_string in route_conf[CONF_HEADERS]:
-                cg.add(route_var.set_header(header_string))  # Add or update
+            cg.add(route_var.set_static_headers(static_headers, len(headers)))
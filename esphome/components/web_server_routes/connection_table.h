@@ -0,0 +1,136 @@
+/**
+ * Web Server Route Handler
+ *
+ * @brief A specialized component for managing HTTP routes on ESP32 devices. It provides
+ * an abstraction layer over the ESP-IDF httpd server, ensuring robust memory management
+ * for HTTP headers
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace web_server_routes {
+
+/**
+ * Connections kept open after a response (keep-alive mode).
+ *
+ * Each slot holds a socket, a key of its peer address (a closed socket's number is reused by the
+ * next connection) and the time its last response completed. Without a free slot the least
+ * recently used idle connection gives way, the same policy as httpd's LRU purge but applied
+ * before httpd runs out of sockets. Only used from the httpd task, so no locking is needed.
+ */
+class ConnectionTable {
+ public:
+  static constexpr size_t MAX_CONNECTIONS = 8;
+
+  void configure(uint32_t idle_timeout_ms, uint8_t max_connections) {
+    this->idle_timeout_ms_ = idle_timeout_ms;
+    this->limit_ = std::clamp<size_t>(max_connections, 1, MAX_CONNECTIONS);
+  }
+
+  bool is_enabled() const { return this->idle_timeout_ms_ > 0; }
+  uint32_t get_idle_timeout() const { return this->idle_timeout_ms_; }
+
+  /**
+   * A request arrived on `fd`.
+   * @param evicted Receives an idle connection to close to make room, -1 if none.
+   * @return false if all slots are busy; the connection is closed after the response.
+   */
+  bool acquire(int fd, uint32_t peer, uint32_t now_ms, int &evicted) {
+    evicted = -1;
+    Slot *slot = this->find_(fd);
+    if (slot == nullptr) {
+      slot = this->find_(-1);
+    }
+    if (slot == nullptr) {
+      // Least recently used idle connection
+      for (size_t i = 0; i < this->limit_; i++) {
+        Slot &candidate = this->slots_[i];
+        if (!candidate.busy && (slot == nullptr || int32_t(candidate.last_ms - slot->last_ms) < 0)) {
+          slot = &candidate;
+        }
+      }
+      if (slot == nullptr) {
+        return false;
+      }
+      evicted = slot->fd;
+    }
+
+    slot->fd = fd;
+    slot->peer = peer;
+    slot->last_ms = now_ms;
+    slot->busy = true;
+    return true;
+  }
+
+  // The response on `fd` is complete, the connection waits for the next request
+  void release(int fd, uint32_t now_ms) {
+    if (Slot *slot = this->find_(fd); slot != nullptr) {
+      slot->busy = false;
+      slot->last_ms = now_ms;
+    }
+  }
+
+  void remove(int fd) {
+    if (Slot *slot = this->find_(fd); slot != nullptr) {
+      *slot = Slot{};
+    }
+  }
+
+  /**
+   * Frees the slots of idle connections older than the idle timeout and of connections that are
+   * gone: `alive(fd, peer)` tells if the socket still belongs to that peer, `close(fd)` is called
+   * for the expired ones.
+   */
+  template<typename Alive, typename Close> void expire(uint32_t now_ms, Alive &&alive, Close &&close) {
+    for (size_t i = 0; i < this->limit_; i++) {
+      Slot &slot = this->slots_[i];
+      if (slot.fd < 0) {
+        continue;
+      }
+      if (!alive(slot.fd, slot.peer)) {
+        slot = Slot{};
+      } else if (!slot.busy && now_ms - slot.last_ms >= this->idle_timeout_ms_) {
+        close(slot.fd);
+        slot = Slot{};
+      }
+    }
+  }
+
+  size_t size() const {
+    return std::count_if(this->slots_.begin(), this->slots_.begin() + this->limit_,
+                         [](const Slot &slot) { return slot.fd >= 0; });
+  }
+
+ protected:
+  struct Slot {
+    int fd{-1};
+    uint32_t peer{0};
+    uint32_t last_ms{0};  // millis() when the last response completed
+    bool busy{false};     // A response is in progress
+  };
+
+  Slot *find_(int fd) {
+    for (size_t i = 0; i < this->limit_; i++) {
+      if (this->slots_[i].fd == fd) {
+        return &this->slots_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  std::array<Slot, MAX_CONNECTIONS> slots_{};
+  size_t limit_{MAX_CONNECTIONS};
+  uint32_t idle_timeout_ms_{0};  // 0 = keep-alive mode off
+};
+
+}  // namespace web_server_routes
+}  // namespace esphome
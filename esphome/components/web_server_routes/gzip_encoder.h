@@ -0,0 +1,339 @@
+/**
+ * Web Server Route Handler
+ *
+ * @brief A specialized component for managing HTTP routes on ESP32 devices. It provides
+ * an abstraction layer over the ESP-IDF httpd server, ensuring robust memory management
+ * for HTTP headers
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+
+namespace esphome {
+namespace web_server_routes {
+
+/**
+ * Streaming gzip compressor (RFC 1951/1952) for response bodies.
+ *
+ * - LZ77 over a sliding window of `window_size` bytes with hash chains (a few probes per
+ *   position, greedy matching).
+ * - Fixed Huffman codes only: no code tables have to be built or sent, which keeps the
+ *   encoder small and fast. JSON, CSV or log text still shrinks to 20-30 %; data that does
+ *   not compress (images) grows by about 5 %.
+ *
+ * RAM: 2 x window (data) + 2 x window (chains) + 1 KB (hash heads) + the output buffer,
+ * i.e. about 6 KB with a 1 KB window. Compressed data is passed to the sink whenever the
+ * output buffer is full, on flush() and on finish().
+ */
+class GzipEncoder {
+ public:
+  using sink_t = std::function<bool(const uint8_t *data, size_t len)>;
+
+  static constexpr size_t MIN_WINDOW = 512;
+  static constexpr size_t MAX_WINDOW = 8192;
+
+  GzipEncoder(size_t window_size, size_t output_size) : window_size_(window_size), output_size_(output_size) {}
+
+  GzipEncoder(const GzipEncoder &) = delete;
+  GzipEncoder &operator=(const GzipEncoder &) = delete;
+
+  // Allocates the buffers and writes the gzip header; false if out of memory
+  bool init() {
+    if (this->window_size_ < MIN_WINDOW || this->window_size_ > MAX_WINDOW ||
+        (this->window_size_ & (this->window_size_ - 1)) != 0) {
+      return false;
+    }
+
+    this->window_.reset(new (std::nothrow) uint8_t[2 * this->window_size_]);
+    this->prev_.reset(new (std::nothrow) uint16_t[this->window_size_]);
+    this->head_.reset(new (std::nothrow) uint16_t[HASH_SIZE]);
+    this->out_.reset(new (std::nothrow) uint8_t[this->output_size_]);
+    if (!this->window_ || !this->prev_ || !this->head_ || !this->out_) {
+      return false;
+    }
+    for (size_t i = 0; i < HASH_SIZE; i++)
+      this->head_[i] = NIL;
+
+    static const uint8_t HEADER[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};  // No name, no mtime
+    for (uint8_t byte : HEADER)
+      this->put_byte_(byte);
+
+    this->start_block_();
+    return true;
+  }
+
+  void set_sink(sink_t sink) { this->sink_ = std::move(sink); }
+
+  // Compresses `len` bytes; false once the sink failed
+  bool write(const uint8_t *data, size_t len) {
+    this->crc_ = crc32(this->crc_, data, len);
+    this->bytes_in_ += len;
+
+    while (len > 0 && this->ok_) {
+      if (this->end_ == 2 * this->window_size_)
+        this->slide_();
+
+      const size_t count = std::min(len, 2 * this->window_size_ - this->end_);
+      memcpy(this->window_.get() + this->end_, data, count);
+      this->end_ += count;
+      data += count;
+      len -= count;
+
+      this->compress_(false);
+    }
+    return this->ok_;
+  }
+
+  /**
+   * Sync flush: everything written so far becomes decodable by the client
+   * (ends the block with an empty stored block, 5 bytes overhead).
+   */
+  bool flush() {
+    this->compress_(true);
+    this->put_bits_(0, 7);  // End of block (fixed code 256)
+    this->put_bits_(0, 3);  // Stored block, not final
+    this->align_();
+    static const uint8_t EMPTY_STORED[4] = {0x00, 0x00, 0xff, 0xff};
+    for (uint8_t byte : EMPTY_STORED)
+      this->put_byte_(byte);
+    this->start_block_();
+    return this->emit_();
+  }
+
+  // Completes the stream (final block and gzip trailer)
+  bool finish() {
+    this->compress_(true);
+    this->put_bits_(0, 7);  // End of block
+    this->put_bits_(1, 1);  // Final, empty fixed block
+    this->put_bits_(1, 2);
+    this->put_bits_(0, 7);
+    this->align_();
+
+    for (int i = 0; i < 4; i++)
+      this->put_byte_(uint8_t(this->crc_ >> (8 * i)));
+    for (int i = 0; i < 4; i++)
+      this->put_byte_(uint8_t(this->bytes_in_ >> (8 * i)));
+    return this->emit_();
+  }
+
+  uint32_t get_bytes_in() const { return this->bytes_in_; }
+  uint32_t get_bytes_out() const { return this->bytes_out_ + this->out_len_; }
+
+  static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len) {
+    static const uint32_t TABLE[16] = {0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4,
+                                       0x4db26158, 0x5005713c, 0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+                                       0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c};
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+      crc ^= data[i];
+      crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+      crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    }
+    return ~crc;
+  }
+
+ protected:
+  static constexpr size_t MIN_MATCH = 3;
+  static constexpr size_t MAX_MATCH = 258;
+  static constexpr size_t HASH_BITS = 9;
+  static constexpr size_t HASH_SIZE = 1 << HASH_BITS;
+  static constexpr uint16_t NIL = 0xFFFF;
+  static constexpr int MAX_PROBES = 8;  // Chain entries compared per position
+
+  uint32_t hash_(size_t pos) const {
+    const uint8_t *p = this->window_.get() + pos;
+    return ((uint32_t(p[0]) << 10) ^ (uint32_t(p[1]) << 5) ^ p[2]) * 2654435761u >> (32 - HASH_BITS);
+  }
+
+  // Links `pos` into its hash chain and returns the previous head
+  uint16_t insert_(size_t pos) {
+    const uint32_t h = this->hash_(pos);
+    const uint16_t candidate = this->head_[h];
+    this->prev_[pos & (this->window_size_ - 1)] = candidate;
+    this->head_[h] = uint16_t(pos);
+    return candidate;
+  }
+
+  // Drops the older half of the window; positions in the tables move along
+  void slide_() {
+    const size_t w = this->window_size_;
+    memmove(this->window_.get(), this->window_.get() + w, this->end_ - w);
+    this->end_ -= w;
+    this->pos_ -= w;
+
+    auto rebase = [w](uint16_t p) { return (p != NIL && p >= w) ? uint16_t(p - w) : NIL; };
+    for (size_t i = 0; i < HASH_SIZE; i++)
+      this->head_[i] = rebase(this->head_[i]);
+    for (size_t i = 0; i < w; i++)
+      this->prev_[i] = rebase(this->prev_[i]);
+  }
+
+  // Encodes the window up to a lookahead of MAX_MATCH bytes, or everything with `all`
+  void compress_(bool all) {
+    const uint8_t *window = this->window_.get();
+
+    while (this->ok_ && this->pos_ < this->end_) {
+      const size_t lookahead = this->end_ - this->pos_;
+      if (lookahead < MAX_MATCH && !all)
+        break;
+
+      size_t best_len = 0;
+      size_t best_dist = 0;
+
+      if (lookahead >= MIN_MATCH) {
+        uint16_t candidate = this->insert_(this->pos_);
+        const size_t max_len = std::min(lookahead, MAX_MATCH);
+
+        for (int probe = 0; probe < MAX_PROBES && candidate != NIL && candidate < this->pos_; probe++) {
+          const size_t dist = this->pos_ - candidate;
+          if (dist > this->window_size_)
+            break;
+
+          // Cheap reject: a longer match has to agree at the current best length
+          if (window[candidate + best_len] == window[this->pos_ + best_len]) {
+            size_t len = 0;
+            while (len < max_len && window[candidate + len] == window[this->pos_ + len])
+              len++;
+            if (len > best_len) {
+              best_len = len;
+              best_dist = dist;
+              if (len == max_len)
+                break;
+            }
+          }
+
+          const uint16_t next = this->prev_[candidate & (this->window_size_ - 1)];
+          if (next >= candidate)
+            break;  // Slot was reused by a newer position
+          candidate = next;
+        }
+      }
+
+      if (best_len >= MIN_MATCH) {
+        this->put_match_(best_len, best_dist);
+        // Index the covered positions as well, so later data can refer to them
+        for (size_t i = 1; i < best_len; i++) {
+          if (this->end_ - (this->pos_ + i) >= MIN_MATCH)
+            this->insert_(this->pos_ + i);
+        }
+        this->pos_ += best_len;
+      } else {
+        this->put_literal_(window[this->pos_]);
+        this->pos_++;
+      }
+    }
+  }
+
+  void start_block_() {
+    this->put_bits_(0, 1);  // Not final
+    this->put_bits_(1, 2);  // Fixed Huffman codes
+  }
+
+  // Huffman codes are defined MSB first, the bit stream is LSB first
+  void put_code_(uint32_t code, int bits) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < bits; i++) {
+      reversed = (reversed << 1) | (code & 1);
+      code >>= 1;
+    }
+    this->put_bits_(reversed, bits);
+  }
+
+  void put_literal_(uint8_t value) {
+    if (value < 144) {
+      this->put_code_(0x30 + value, 8);
+    } else {
+      this->put_code_(0x190 + value - 144, 9);
+    }
+  }
+
+  void put_match_(size_t len, size_t dist) {
+    static const uint16_t LEN_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                          31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t LEN_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                          2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t DIST_BASE[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                           193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    int code = 28;
+    while (LEN_BASE[code] > len)
+      code--;
+    const uint32_t symbol = 257 + code;
+    if (symbol < 280) {
+      this->put_code_(symbol - 256, 7);
+    } else {
+      this->put_code_(0xC0 + symbol - 280, 8);
+    }
+    this->put_bits_(len - LEN_BASE[code], LEN_EXTRA[code]);
+
+    code = 29;
+    while (DIST_BASE[code] > dist)
+      code--;
+    this->put_code_(code, 5);
+    this->put_bits_(dist - DIST_BASE[code], DIST_EXTRA[code]);
+  }
+
+  void put_bits_(uint32_t value, int bits) {
+    this->bit_buffer_ |= value << this->bit_count_;
+    this->bit_count_ += bits;
+    while (this->bit_count_ >= 8) {
+      this->put_byte_(uint8_t(this->bit_buffer_));
+      this->bit_buffer_ >>= 8;
+      this->bit_count_ -= 8;
+    }
+  }
+
+  void align_() {
+    if (this->bit_count_ > 0)
+      this->put_bits_(0, 8 - this->bit_count_);
+  }
+
+  void put_byte_(uint8_t byte) {
+    this->out_[this->out_len_++] = byte;
+    if (this->out_len_ == this->output_size_)
+      this->emit_();
+  }
+
+  bool emit_() {
+    if (this->out_len_ > 0 && this->ok_) {
+      this->ok_ = this->sink_ && this->sink_(this->out_.get(), this->out_len_);
+      this->bytes_out_ += this->out_len_;
+    }
+    this->out_len_ = 0;
+    return this->ok_;
+  }
+
+  size_t window_size_;
+  size_t output_size_;
+  sink_t sink_;
+
+  std::unique_ptr<uint8_t[]> window_;  // History (first half) and new data
+  std::unique_ptr<uint16_t[]> prev_;   // Hash chains, indexed by position modulo window
+  std::unique_ptr<uint16_t[]> head_;   // Newest position per hash
+  std::unique_ptr<uint8_t[]> out_;
+  size_t pos_{0};  // Next position to encode
+  size_t end_{0};  // End of the data in `window_`
+  size_t out_len_{0};
+
+  uint32_t bit_buffer_{0};
+  int bit_count_{0};
+  uint32_t crc_{0};
+  uint32_t bytes_in_{0};
+  uint32_t bytes_out_{0};
+  bool ok_{true};
+};
+
+}  // namespace web_server_routes
+}  // namespace esphome
@@ -0,0 +1,175 @@
+/**
+ * Web Server Route Handler
+ *
+ * @brief A specialized component for managing HTTP routes on ESP32 devices. It provides
+ * an abstraction layer over the ESP-IDF httpd server, ensuring robust memory management
+ * for HTTP headers
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace esphome {
+namespace web_server_routes {
+
+/**
+ * Query string of one request, parsed once into percent-decoded key/value views.
+ *
+ * The query is copied into storage owned by this object (inline for short queries) and
+ * decoded in place; every key and value is NUL terminated there, so the views can also be
+ * passed to C functions. Lookups are a linear scan over at most MAX_PARAMS entries.
+ */
+class QueryParams {
+ public:
+  static constexpr size_t MAX_PARAMS = 16;  // Further parameters are ignored
+  static constexpr size_t INLINE_SIZE = 128;
+
+  QueryParams() = default;
+  QueryParams(const QueryParams &) = delete;  // Views point into the own storage
+  QueryParams &operator=(const QueryParams &) = delete;
+
+  // Parses the part after '?' of `uri` (a URI without query gives no parameters)
+  void parse(const char *uri) {
+    this->count_ = 0;
+    const char *query = (uri != nullptr) ? strchr(uri, '?') : nullptr;
+    if (query == nullptr) {
+      return;
+    }
+    query++;
+
+    const size_t len = strlen(query);
+    char *buffer = this->inline_;
+    if (len >= INLINE_SIZE) {
+      this->heap_.reset(new (std::nothrow) char[len + 1]);
+      if (this->heap_ == nullptr) {
+        return;
+      }
+      buffer = this->heap_.get();
+    }
+    memcpy(buffer, query, len + 1);
+
+    char *pos = buffer;
+    while (*pos != '\0' && this->count_ < MAX_PARAMS) {
+      char *end = pos + strcspn(pos, "&");
+      char *next = (*end != '\0') ? end + 1 : end;
+      *end = '\0';
+
+      if (pos != end) {
+        char *value = end;  // "?flag" has an empty value
+        if (char *eq = strchr(pos, '='); eq != nullptr) {
+          *eq = '\0';
+          value = eq + 1;
+        }
+        const size_t key_len = decode_(pos);
+        const size_t value_len = decode_(value);
+        this->params_[this->count_++] = {std::string_view(pos, key_len), std::string_view(value, value_len)};
+      }
+      pos = next;
+    }
+  }
+
+  bool has(std::string_view key) const { return this->find_(key) != nullptr; }
+
+  // Value of the first parameter named `key`, empty if it is missing
+  std::string_view get(std::string_view key) const {
+    const auto *param = this->find_(key);
+    return (param != nullptr) ? param->second : std::string_view();
+  }
+
+  int32_t get_int(std::string_view key, int32_t fallback) const {
+    std::string_view value = this->get(key);
+    if (value.empty()) {
+      return fallback;
+    }
+    char *end;
+    long result = strtol(value.data(), &end, 10);
+    return (end == value.data() + value.size()) ? int32_t(result) : fallback;
+  }
+
+  float get_float(std::string_view key, float fallback) const {
+    std::string_view value = this->get(key);
+    if (value.empty()) {
+      return fallback;
+    }
+    char *end;
+    float result = strtof(value.data(), &end);
+    return (end == value.data() + value.size()) ? result : fallback;
+  }
+
+  // 1/true/on/yes and a bare "?key" are true, 0/false/off/no are false
+  bool get_bool(std::string_view key, bool fallback) const {
+    const auto *param = this->find_(key);
+    if (param == nullptr) {
+      return fallback;
+    }
+    std::string_view value = param->second;
+    if (value.empty() || value == "1" || value == "true" || value == "on" || value == "yes") {
+      return true;
+    }
+    if (value == "0" || value == "false" || value == "off" || value == "no") {
+      return false;
+    }
+    return fallback;
+  }
+
+  size_t size() const { return this->count_; }
+  const std::pair<std::string_view, std::string_view> &operator[](size_t index) const { return this->params_[index]; }
+
+ protected:
+  const std::pair<std::string_view, std::string_view> *find_(std::string_view key) const {
+    for (size_t i = 0; i < this->count_; i++) {
+      if (this->params_[i].first == key) {
+        return &this->params_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  static int hex_value_(char c) {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  }
+
+  // Decodes %XX and '+' in place, returns the new length
+  static size_t decode_(char *text) {
+    char *out = text;
+    for (const char *in = text; *in != '\0'; in++) {
+      int high, low;
+      if (*in == '+') {
+        *out++ = ' ';
+      } else if (*in == '%' && (high = hex_value_(in[1])) >= 0 && (low = hex_value_(in[2])) >= 0) {
+        *out++ = char(high << 4 | low);
+        in += 2;
+      } else {
+        *out++ = *in;  // Also malformed escapes, which are kept as they are
+      }
+    }
+    *out = '\0';
+    return out - text;
+  }
+
+  char inline_[INLINE_SIZE];
+  std::unique_ptr<char[]> heap_;  // Only for queries longer than INLINE_SIZE
+  std::array<std::pair<std::string_view, std::string_view>, MAX_PARAMS> params_;
+  size_t count_{0};
+};
+
+}  // namespace web_server_routes
+}  // namespace esphome
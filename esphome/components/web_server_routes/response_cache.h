@@ -0,0 +1,141 @@
+/**
+ * Web Server Route Handler
+ *
+ * @brief A specialized component for managing HTTP routes on ESP32 devices. It provides
+ * an abstraction layer over the ESP-IDF httpd server, ensuring robust memory management
+ * for HTTP headers
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include "esphome/core/helpers.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace esphome {
+namespace web_server_routes {
+
+/**
+ * Responses of routes with `cache_ttl`, replayed without running the lambda while fresh.
+ *
+ * Entries are keyed by the request URI (path and query) and evicted least recently used
+ * once the bodies and headers exceed the capacity. Bodies prefer PSRAM (RAMAllocator).
+ * Only used from the httpd task, so no locking is needed.
+ */
+class ResponseCache {
+ public:
+  struct Entry {
+    std::string key;
+    uint32_t expires;     // millis()
+    std::string status;   // Status line set with set_status(), empty for 200 OK
+    std::string headers;  // Headers set in the lambda: "field\0value\0" pairs
+    std::string etag;     // Validator passed to check_etag(), empty if none
+    uint8_t *body{nullptr};
+    size_t body_len{0};
+
+    size_t size() const {
+      return this->key.size() + this->status.size() + this->headers.size() + this->etag.size() + this->body_len;
+    }
+  };
+
+  ~ResponseCache() { this->clear(); }
+
+  void set_capacity(size_t capacity) { this->capacity_ = capacity; }
+  size_t get_capacity() const { return this->capacity_; }
+  size_t get_used() const { return this->used_; }
+  size_t get_entry_count() const { return this->entries_.size(); }
+
+  // Largest entry worth capturing: a single response must not displace the whole cache
+  size_t max_entry_size() const { return this->capacity_ / 2; }
+
+  // Fresh entry for `key` (marked as most recently used), nullptr if missing or expired
+  const Entry *find(const std::string &key, uint32_t now) {
+    auto it = this->index_.find(key);
+    if (it == this->index_.end()) {
+      return nullptr;
+    }
+
+    auto entry = it->second;
+    if (int32_t(entry->expires - now) <= 0) {
+      this->erase_(entry);
+      return nullptr;
+    }
+
+    this->entries_.splice(this->entries_.begin(), this->entries_, entry);
+    return &*entry;
+  }
+
+  /**
+   * Stores a response, replacing an older one with the same key.
+   * @return false if it does not fit or there is no memory for the body.
+   */
+  bool insert(std::string key, uint32_t expires, std::string status, std::string headers, std::string etag,
+              const std::string &body) {
+    if (auto it = this->index_.find(key); it != this->index_.end()) {
+      this->erase_(it->second);
+    }
+
+    Entry entry;
+    entry.key = std::move(key);
+    entry.expires = expires;
+    entry.status = std::move(status);
+    entry.headers = std::move(headers);
+    entry.etag = std::move(etag);
+    entry.body_len = body.size();
+    if (entry.size() > this->max_entry_size()) {
+      return false;
+    }
+
+    while (!this->entries_.empty() && this->used_ + entry.size() > this->capacity_) {
+      this->erase_(std::prev(this->entries_.end()));
+    }
+
+    if (entry.body_len > 0) {
+      RAMAllocator<uint8_t> allocator;
+      entry.body = allocator.allocate(entry.body_len);
+      if (entry.body == nullptr) {
+        return false;
+      }
+      memcpy(entry.body, body.data(), entry.body_len);
+    }
+
+    this->used_ += entry.size();
+    this->entries_.push_front(std::move(entry));
+    this->index_[this->entries_.front().key] = this->entries_.begin();  // Key view into the list node
+    return true;
+  }
+
+  void clear() {
+    while (!this->entries_.empty()) {
+      this->erase_(this->entries_.begin());
+    }
+  }
+
+ protected:
+  void erase_(std::list<Entry>::iterator entry) {
+    if (entry->body != nullptr) {
+      RAMAllocator<uint8_t> allocator;
+      allocator.deallocate(entry->body, entry->body_len);
+    }
+    this->used_ -= entry->size();
+    this->index_.erase(entry->key);
+    this->entries_.erase(entry);
+  }
+
+  size_t capacity_{16384};
+  size_t used_{0};
+  std::list<Entry> entries_;  // Most recently used first
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace web_server_routes
+}  // namespace esphome
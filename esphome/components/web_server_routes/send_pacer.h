@@ -0,0 +1,110 @@
+/**
+ * Web Server Route Handler
+ *
+ * @brief A specialized component for managing HTTP routes on ESP32 devices. It provides
+ * an abstraction layer over the ESP-IDF httpd server, ensuring robust memory management
+ * for HTTP headers
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include "esphome/core/helpers.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace web_server_routes {
+
+/**
+ * Pacing of chunked sends on a congested connection.
+ *
+ * - Retries back off exponentially with jitter (half to full backoff), bounded by a deadline
+ *   per chunk instead of a fixed number of attempts.
+ * - Successful sends update a running throughput estimate (EWMA); large payloads are split
+ *   into chunks worth about TARGET_CHUNK_MS of transfer time.
+ *
+ * The pacer only decides; the caller measures time, sends and waits. This keeps it free of
+ * ESP-IDF calls and testable on the host.
+ */
+class SendPacer {
+ public:
+  static constexpr uint32_t INITIAL_BACKOFF_MS = 5;
+  static constexpr uint32_t MAX_BACKOFF_MS = 250;
+  static constexpr uint32_t TARGET_CHUNK_MS = 20;  // Transfer time a chunk should take
+  static constexpr size_t MIN_CHUNK = 512;
+  static constexpr size_t MAX_CHUNK = 8192;
+
+  void set_deadline(uint32_t deadline_ms) { this->deadline_ms_ = deadline_ms; }
+
+  // Starts a new chunk: resets the backoff and the deadline
+  void begin(uint32_t now_ms) {
+    this->start_ms_ = now_ms;
+    this->backoff_ms_ = INITIAL_BACKOFF_MS;
+    this->attempts_ = 0;
+  }
+
+  // A chunk of `bytes` was accepted after `elapsed_us`
+  void on_sent(size_t bytes, uint32_t elapsed_us) {
+    if (elapsed_us == 0)
+      elapsed_us = 1;
+    const uint32_t rate = uint32_t(std::min<uint64_t>(uint64_t(bytes) * 1000000u / elapsed_us, UINT32_MAX));
+
+    // EWMA with weight 1/4, seeded by the first measurement
+    this->throughput_ = (this->throughput_ == 0) ? rate : this->throughput_ - this->throughput_ / 4 + rate / 4;
+  }
+
+  /**
+   * The send failed because the connection is congested.
+   * @param delay_ms Receives the time to wait before the next attempt.
+   * @return false if the deadline is exceeded and the send should be given up.
+   */
+  bool on_congested(uint32_t now_ms, uint32_t &delay_ms) {
+    const uint32_t elapsed = now_ms - this->start_ms_;
+    if (elapsed >= this->deadline_ms_) {
+      this->timeouts_++;
+      return false;
+    }
+
+    if (this->attempts_++ == 0)
+      this->stalls_++;
+    this->retries_++;
+
+    // Jitter keeps parallel senders from retrying in lockstep
+    const uint32_t half = this->backoff_ms_ / 2;
+    delay_ms = half + random_uint32() % (this->backoff_ms_ - half + 1);
+    delay_ms = std::min(delay_ms, this->deadline_ms_ - elapsed);
+
+    this->backoff_ms_ = std::min(this->backoff_ms_ * 2, MAX_BACKOFF_MS);
+    return true;
+  }
+
+  // Recommended size of the next chunk (MAX_CHUNK until the throughput is known)
+  size_t chunk_size() const {
+    if (this->throughput_ == 0)
+      return MAX_CHUNK;
+    const size_t size = size_t(uint64_t(this->throughput_) * TARGET_CHUNK_MS / 1000);
+    return std::clamp(size, MIN_CHUNK, MAX_CHUNK);
+  }
+
+  uint32_t get_throughput() const { return this->throughput_; }  // Bytes per second
+  uint32_t get_retries() const { return this->retries_; }        // Attempts that had to be repeated
+  uint32_t get_stalls() const { return this->stalls_; }          // Chunks that needed at least one retry
+  uint32_t get_timeouts() const { return this->timeouts_; }      // Chunks given up at the deadline
+
+ protected:
+  uint32_t deadline_ms_{2000};
+  uint32_t start_ms_{0};
+  uint32_t backoff_ms_{INITIAL_BACKOFF_MS};
+  uint32_t attempts_{0};
+  uint32_t throughput_{0};
+  uint32_t retries_{0};
+  uint32_t stalls_{0};
+  uint32_t timeouts_{0};
+};
+
+}  // namespace web_server_routes
+}  // namespace esphome
@@ -0,0 +1,94 @@
+/**
+ * Web Server Route Handler
+ *
+ * @brief A specialized component for managing HTTP routes on ESP32 devices. It provides
+ * an abstraction layer over the ESP-IDF httpd server, ensuring robust memory management
+ * for HTTP headers
+ *
+ * @author fschroedter
+ * @copyright MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace esphome {
+namespace web_server_routes {
+
+/**
+ * Lock-free token bucket: `rate` requests per second on average, bursts of up to `burst`.
+ *
+ * Token count (in millionths of a token) and the time of the last refill share one 64 bit
+ * word that is updated with compare-and-swap, so it can be checked from any task without a
+ * mutex (32 bit targets emulate the 64 bit CAS with a short critical section). A bucket with
+ * rate 0 is disabled and admits everything.
+ */
+class TokenBucket {
+ public:
+  void configure(float rate, uint32_t burst) {
+    this->refill_ = uint32_t(rate * (UNIT / 1000));  // Per millisecond
+    this->capacity_ = std::max<uint32_t>(burst, 1) * UNIT;
+    this->state_.store(pack_(this->capacity_, 0));
+  }
+
+  bool is_enabled() const { return this->refill_ > 0; }
+
+  /**
+   * Takes one token.
+   * @param retry_after_ms Receives the time until a token is available if none is left.
+   */
+  bool try_acquire(uint32_t now_ms, uint32_t &retry_after_ms) {
+    if (!this->is_enabled()) {
+      return true;
+    }
+
+    uint64_t state = this->state_.load(std::memory_order_relaxed);
+    while (true) {
+      const uint32_t elapsed = now_ms - uint32_t(state >> 32);
+      const uint64_t refilled = uint64_t(uint32_t(state)) + uint64_t(elapsed) * this->refill_;
+      const uint32_t tokens = uint32_t(std::min<uint64_t>(refilled, this->capacity_));
+
+      if (tokens < UNIT) {
+        retry_after_ms = (UNIT - tokens + this->refill_ - 1) / this->refill_;
+        return false;  // Nothing stored: the refill is recomputed from the same point next time
+      }
+
+      if (this->state_.compare_exchange_weak(state, pack_(tokens - UNIT, now_ms), std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Returns a token taken by try_acquire() that was not used, e.g. because a later check
+   * rejected the request. The bucket never holds more than `burst` tokens.
+   */
+  void refund() {
+    if (!this->is_enabled()) {
+      return;
+    }
+
+    uint64_t state = this->state_.load(std::memory_order_relaxed);
+    while (true) {
+      const uint32_t tokens = uint32_t(std::min<uint64_t>(uint64_t(uint32_t(state)) + UNIT, this->capacity_));
+      if (this->state_.compare_exchange_weak(state, pack_(tokens, uint32_t(state >> 32)), std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+ protected:
+  static constexpr uint32_t UNIT = 1000000;  // One token
+
+  static uint64_t pack_(uint32_t tokens, uint32_t time_ms) { return (uint64_t(time_ms) << 32) | tokens; }
+
+  uint32_t refill_{0};  // Millionths of a token per millisecond
+  uint32_t capacity_{UNIT};
+  std::atomic<uint64_t> state_{0};
+};
+
+}  // namespace web_server_routes
+}  // namespace esphome
@@ -10,30 +10,104 @@
  */
 
 #include "web_server_routes.h"
+#include "esphome/core/hal.h"
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "esphome/components/web_server_base/web_server_base.h"
 #include "esphome/components/web_server_idf/web_server_idf.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <esp_http_server.h>
+#include <esp_idf_version.h>
+#include <esp_timer.h>
 #include <functional>
 #include <list>
-#include <optional>
 #include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <unordered_map>
 #include <vector>
 
+// Async request handlers (httpd_req_async_handler_begin) are available since ESP-IDF 5.1
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#define WEB_SERVER_ROUTES_ASYNC_STREAM
+#endif
+
 namespace esphome {
 namespace web_server_routes {
 
+static const uint32_t STREAM_RETRY_MS = 10;  // Delay before a pending producer is asked again
+
 WebServerRoutes::RouteEntry *WebServerRoutes::add_route(WebServerRoutes::RouteEntry *route) {
   if (route == nullptr)
     return nullptr;
 
   this->routes_.push_back(std::unique_ptr<WebServerRoutes::RouteEntry>(route));
+  this->index_route_(route);
   return route;
 }
 
+// Removes a trailing slash ("/info/" matches the route "/info"); the root path stays "/"
+static std::string_view normalize_url_path(std::string_view path) {
+  if (path.size() > 1 && path.back() == '/')
+    path.remove_suffix(1);
+  return path;
+}
+
+// True if the query string ("a=1&b") contains the parameter `key`, with or without value
+static bool has_query_key(std::string_view query, std::string_view key) {
+  while (!query.empty()) {
+    size_t end = query.find('&');
+    std::string_view param = query.substr(0, end);
+    if (param.substr(0, param.find('=')) == key)
+      return true;
+    if (end == std::string_view::npos)
+      break;
+    query.remove_prefix(end + 1);
+  }
+  return false;
+}
+
+void WebServerRoutes::index_route_(RouteEntry *route) {
+  auto &routes = this->route_index_[normalize_url_path(route->path)];
+
+  // Routes with a key are more specific and are checked first, each group in definition order
+  auto pos = routes.end();
+  if (!route->key.empty()) {
+    pos = std::find_if(routes.begin(), routes.end(), [](const RouteEntry *r) { return r->key.empty(); });
+  }
+  routes.insert(pos, route);
+}
+
+/**
+ * Looks up the route for a raw request URI ("/path?query").
+ * Works on views of the URI and does not allocate.
+ */
+WebServerRoutes::RouteEntry *WebServerRoutes::find_route_(const char *uri) const {
+  std::string_view url(uri);
+  std::string_view query;
+
+  size_t query_pos = url.find('?');
+  if (query_pos != std::string_view::npos) {
+    query = url.substr(query_pos + 1);
+    url = url.substr(0, query_pos);
+  }
+
+  auto it = this->route_index_.find(normalize_url_path(url));
+  if (it == this->route_index_.end())
+    return nullptr;
+
+  for (RouteEntry *route : it->second) {
+    if (route->key.empty() || has_query_key(query, route->key))
+      return route;
+  }
+  return nullptr;
+}
+
 void WebServerRoutes::setup() {
   // Backup solution: If base was not set via YAML, search globally.
   if (this->base_ == nullptr) {
@@ -57,30 +131,89 @@ void WebServerRoutes::setup() {
   }
 
   server->addHandler(new RouteHandler(this));
+
+  if (this->connections_.is_enabled()) {
+    // The table belongs to the httpd task, the check is queued there
+    this->set_interval("keep_alive", 1000, [this]() {
+      httpd_handle_t httpd = this->httpd_.load();
+      if (httpd != nullptr) {
+        httpd_queue_work(httpd, &WebServerRoutes::expire_connections_, this);
+      }
+    });
+  }
 }
 
-esp_err_t WebServerRoutes::send(const std::string &data) {  //
+esp_err_t RouteContext::send(const std::string &data) {  //
   return this->send_binary(data.c_str(), data.length());
 }
 
-esp_err_t WebServerRoutes::send(const char *format, ...) {
+/**
+ * Formats straight into the free tail of the output buffer. Only if the text does not fit, the
+ * buffer is flushed and the text formatted again; text longer than the whole buffer is formatted
+ * into a temporary allocation and sent directly.
+ */
+esp_err_t RouteContext::send(const char *format, ...) {
+  if (!this->check_request_()) {
+    return ESP_FAIL;
+  }
+
   va_list arg;
   va_start(arg, format);
 
-  // Determine the length of the resulting string
-  va_list arg_copy;
-  va_copy(arg_copy, arg);
-  int len = vsnprintf(nullptr, 0, format, arg_copy);
-  va_end(arg_copy);  // Clean up the copy
-
   esp_err_t res = ESP_OK;
 
-  if (len > 0) {
-    // Create a buffer with enough space
-    std::vector<char> buf(len + 1);
-    vsnprintf(buf.data(), buf.size(), format, arg);
+  if (this->ensure_buffer_()) {
+    va_list arg_copy;
+    va_copy(arg_copy, arg);
+    const size_t space = OUTPUT_BUFFER_SIZE - this->out_len_;
+    int len = vsnprintf(this->out_buffer_.get() + this->out_len_, space, format, arg_copy);
+    va_end(arg_copy);
+
+    if (len < 0) {
+      res = ESP_FAIL;
+    } else if (size_t(len) < space) {
+      // Fits (vsnprintf needs one more byte for the terminator)
+      this->out_len_ += len;
+    } else if (size_t(len) < OUTPUT_BUFFER_SIZE) {
+      res = this->flush_();
+      if (res == ESP_OK) {
+        this->out_len_ = vsnprintf(this->out_buffer_.get(), OUTPUT_BUFFER_SIZE, format, arg);
+      }
+    } else {
+      res = this->flush_();
+      std::unique_ptr<char[]> text(new (std::nothrow) char[len + 1]);
+      if (res == ESP_OK && text != nullptr) {
+        vsnprintf(text.get(), len + 1, format, arg);
+        res = this->write_(text.get(), len);
+      } else if (text == nullptr) {
+        res = ESP_ERR_NO_MEM;
+      }
+    }
+  } else {
+    // No output buffer: format on the stack, longer texts on the heap
+    va_list arg_copy;
+    va_copy(arg_copy, arg);
+    char text[128];
+    int len = vsnprintf(text, sizeof(text), format, arg_copy);
+    va_end(arg_copy);
 
-    res = this->send(std::string(buf.data()));
+    if (len < 0) {
+      res = ESP_FAIL;
+    } else if (size_t(len) < sizeof(text)) {
+      if (len > 0) {
+        res = this->write_(text, len);
+      }
+    } else {
+      std::unique_ptr<char[]> heap_text(new (std::nothrow) char[len + 1]);
+      if (heap_text == nullptr) {
+        // A truncated text would corrupt the body: send nothing and report it
+        ESP_LOGW(TAG, "Not enough memory to format %d bytes", len);
+        res = ESP_ERR_NO_MEM;
+      } else {
+        vsnprintf(heap_text.get(), len + 1, format, arg);
+        res = this->write_(heap_text.get(), len);
+      }
+    }
   }
 
   va_end(arg);  // Clean up variadic arguments and ensure stack stability.
@@ -88,100 +221,447 @@ esp_err_t WebServerRoutes::send(const char *format, ...) {
   return res;
 }
 
-esp_err_t WebServerRoutes::send_binary(const char *data, size_t len) {
-  // if (!this->check_request_()) {
-  if (!this->check_request_() || len == 0) {
-    return ESP_FAIL;
+esp_err_t RouteContext::send_uint(uint32_t value) {
+  char digits[10];
+  size_t pos = sizeof(digits);
+  do {
+    digits[--pos] = char('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  return this->send_binary(digits + pos, sizeof(digits) - pos);
+}
+
+esp_err_t RouteContext::send_int(int32_t value) {
+  if (value >= 0) {
+    return this->send_uint(value);
+  }
+  esp_err_t res = this->send_binary("-", 1);
+  if (res != ESP_OK) {
+    return res;
+  }
+  return this->send_uint(uint32_t(0) - uint32_t(value));  // Also correct for INT32_MIN
+}
+
+esp_err_t RouteContext::send_float(float value, uint8_t decimals) {
+  if (!std::isfinite(value)) {
+    return this->send_binary("null", 4);
+  }
+
+  static const uint32_t SCALE[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+  decimals = std::min<uint8_t>(decimals, 6);
+
+  // Fixed point with rounding; values out of range fall back to printf
+  const double scaled = std::fabs(double(value)) * SCALE[decimals] + 0.5;
+  if (scaled >= 4294967295.0 * SCALE[decimals]) {
+    return this->send("%.*f", decimals, value);
+  }
+
+  const uint64_t fixed = uint64_t(scaled);
+  const uint32_t integer = uint32_t(fixed / SCALE[decimals]);
+  uint32_t fraction = uint32_t(fixed % SCALE[decimals]);
+
+  char text[24];
+  size_t len = 0;
+  if (value < 0 && fixed != 0) {
+    text[len++] = '-';
   }
 
-  uint8_t max_retries = 15;
+  char digits[10];
+  size_t pos = sizeof(digits);
+  uint32_t v = integer;
+  do {
+    digits[--pos] = char('0' + v % 10);
+    v /= 10;
+  } while (v != 0);
+  memcpy(text + len, digits + pos, sizeof(digits) - pos);
+  len += sizeof(digits) - pos;
+
+  if (decimals > 0) {
+    text[len++] = '.';
+    for (int i = decimals - 1; i >= 0; i--) {
+      text[len + i] = char('0' + fraction % 10);
+      fraction /= 10;
+    }
+    len += decimals;
+  }
+  return this->send_binary(text, len);
+}
+
+/**
+ * Sends text escaped for a JSON string (quotes, backslashes and control characters).
+ * Runs of characters that need no escaping are sent in one piece.
+ */
+esp_err_t RouteContext::send_escaped(std::string_view text) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
   esp_err_t res = ESP_OK;
+  size_t start = 0;
 
-  for (uint8_t i = 0; i < max_retries; i++) {
-    res = httpd_resp_send_chunk(this->current_req_, data, len);
+  for (size_t i = 0; i < text.size() && res == ESP_OK; i++) {
+    const unsigned char c = text[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    if (i > start) {
+      res = this->send_binary(text.data() + start, i - start);
+    }
+    start = i + 1;
 
+    char escaped[6] = {'\\', char(c), 0, 0, 0, 0};
+    size_t len = 2;
+    switch (c) {
+      case '"':
+      case '\\':
+        break;
+      case '\n':
+        escaped[1] = 'n';
+        break;
+      case '\r':
+        escaped[1] = 'r';
+        break;
+      case '\t':
+        escaped[1] = 't';
+        break;
+      default:
+        memcpy(escaped + 1, "u00", 3);
+        escaped[4] = HEX_DIGITS[c >> 4];
+        escaped[5] = HEX_DIGITS[c & 0x0F];
+        len = 6;
+        break;
+    }
     if (res == ESP_OK) {
-      return ESP_OK;
+      res = this->send_binary(escaped, len);
     }
+  }
 
-    if (res == ESP_ERR_HTTPD_RESP_SEND || res == ESP_ERR_TIMEOUT) {
-      // Buffer full: Wait briefly and give the TCP stack time for ACKs.
-      ESP_LOGW(TAG, "Buffer full (chunk congestion), waiting for TCP ACKs... (Attempt %d/%d)", i + 1, max_retries);
+  if (res == ESP_OK && text.size() > start) {
+    res = this->send_binary(text.data() + start, text.size() - start);
+  }
+  return res;
+}
 
-      // Give the RTOS time to handle other tasks (WLAN stack). 30ms is a good value to wait for Wi-Fi acknowledgement
-      vTaskDelay(pdMS_TO_TICKS(30));
-      continue;
+bool RouteContext::ensure_buffer_() {
+  if (this->out_buffer_ == nullptr) {
+    this->out_buffer_.reset(new (std::nothrow) char[OUTPUT_BUFFER_SIZE]);
+  }
+  return this->out_buffer_ != nullptr;
+}
+
+/**
+ * Sends raw data. Writes smaller than a TCP segment are collected in the output buffer and sent
+ * as full segments; larger ones are sent directly from `data` after the buffer was flushed.
+ */
+esp_err_t RouteContext::send_binary(const char *data, size_t len) {
+  if (!this->check_request_() || len == 0) {
+    return ESP_FAIL;
+  }
+
+  if (len >= OUTPUT_BUFFER_SIZE) {
+    esp_err_t res = this->flush_();
+    if (res != ESP_OK) {
+      return res;
+    }
+    return this->write_(data, len);
+  }
+
+  if (!this->ensure_buffer_()) {
+    return this->write_(data, len);  // Unbuffered
+  }
+
+  while (len > 0) {
+    const size_t count = std::min(len, OUTPUT_BUFFER_SIZE - this->out_len_);
+    memcpy(this->out_buffer_.get() + this->out_len_, data, count);
+    this->out_len_ += count;
+    data += count;
+    len -= count;
+
+    if (this->out_len_ == OUTPUT_BUFFER_SIZE) {
+      esp_err_t res = this->flush_();
+      if (res != ESP_OK) {
+        return res;
+      }
+    }
+  }
+  return ESP_OK;
+}
+
+esp_err_t RouteContext::flush() {
+  esp_err_t res = this->flush_();
+  if (res == ESP_OK && this->encoder_ != nullptr && this->is_active()) {
+    res = this->encoder_->flush() ? ESP_OK : ESP_FAIL;
+  }
+  return res;
+}
+
+// Hands the output buffer on (to the encoder, if any)
+esp_err_t RouteContext::flush_() {
+  if (this->out_len_ == 0) {
+    return ESP_OK;
+  }
+
+  const size_t len = this->out_len_;
+  this->out_len_ = 0;
+  if (!this->check_request_()) {
+    return ESP_FAIL;
+  }
+  return this->write_(this->out_buffer_.get(), len);
+}
+
+/**
+ * Completes the response after the lambda (and an inline stream) returned.
+ * A body that is still completely in the buffer goes out in one send with Content-Length: no
+ * chunk framing, and no separate segment for the final chunk, which Nagle's algorithm may hold
+ * back until the client acknowledges the previous one. Everything else ends with the final chunk.
+ * @return true if the client received the complete response.
+ */
+bool RouteContext::end_response_() {
+  if (!this->is_active()) {
+    return this->finished_;
+  }
+
+  if (!this->chunked_ && this->encoder_ == nullptr) {
+    this->sized_ = true;
+    this->flush_();
+    if (!this->finished_ && this->is_active()) {
+      this->send_sized_(nullptr, 0);  // Empty body
+    }
+    return this->finished_;
+  }
+
+  this->flush_();
+  this->finish_encoding_();
+  if (!this->is_active()) {
+    return false;
+  }
+
+  esp_err_t res = httpd_resp_send_chunk(this->req_, nullptr, 0);
+  if (res != ESP_OK) {
+    ESP_LOGW(TAG, "Final chunk failed: %s", esp_err_to_name(res));
+    return false;
+  }
+  this->finished_ = true;
+  return true;
+}
+
+// Sends headers and the whole body at once (httpd_resp_send() sets Content-Length)
+esp_err_t RouteContext::send_sized_(const char *data, size_t len) {
+  if (this->content_length_ >= 0 && this->content_length_ != int64_t(len)) {
+    ESP_LOGW(TAG, "Content size %lld announced, %zu bytes sent", (long long) this->content_length_, len);
+  }
+
+  const uint32_t start = micros();
+  esp_err_t res = httpd_resp_send(this->req_, data, len);
+  if (res != ESP_OK) {
+    ESP_LOGW(TAG, "Sending response failed: %s", esp_err_to_name(res));
+    this->close_();
+    return res;
+  }
+
+  this->pacer_.on_sent(len, micros() - start);
+  this->finished_ = true;
+  return ESP_OK;
+}
+
+esp_err_t RouteContext::write_(const char *data, size_t len) {
+  if (this->capturing_) {
+    if (this->capture_body_.size() + len > this->capture_limit_) {
+      ESP_LOGD(TAG, "Response too large for the cache");
+      this->capturing_ = false;
+      std::string().swap(this->capture_body_);
     } else {
+      this->capture_body_.append(data, len);
+    }
+  }
+
+  if (this->encoder_ != nullptr) {
+    // Compressed data reaches write_raw_() through the encoder's sink
+    return this->encoder_->write(reinterpret_cast<const uint8_t *>(data), len) ? ESP_OK : ESP_FAIL;
+  }
+  return this->write_raw_(data, len);
+}
+
+/**
+ * Sends raw data as one or more HTTP chunks.
+ * Payloads larger than the pacer's chunk size (derived from the measured throughput) are split,
+ * so a congested link is not handed more data than it can take within a few retries.
+ */
+esp_err_t RouteContext::write_raw_(const char *data, size_t len) {
+  if (this->finished_) {
+    ESP_LOGW(TAG, "Response already complete, %zu bytes dropped", len);
+    return ESP_FAIL;
+  }
+
+  // The whole body announced by send_content_size() in one write: no need for chunks
+  const bool whole_body = !this->chunked_ && this->encoder_ == nullptr && this->content_length_ == int64_t(len);
+  if (this->sized_ || whole_body) {
+    return this->send_sized_(data, len);
+  }
+
+  size_t offset = 0;
+  while (offset < len) {
+    const size_t chunk = std::min(len - offset, this->pacer_.chunk_size());
+    esp_err_t res = this->send_chunk_(data + offset, chunk);
+    if (res != ESP_OK) {
+      return res;
+    }
+    offset += chunk;
+  }
+  return ESP_OK;
+}
+
+esp_err_t RouteContext::send_chunk_(const char *data, size_t len) {
+  this->pacer_.begin(millis());
+  if (!this->chunked_ && this->content_length_ >= 0) {
+    // HTTP/1.1 forbids Content-Length together with chunked transfer encoding
+    ESP_LOGD(TAG, "Content size not sent, the response is chunked");
+  }
+  this->chunked_ = true;
+
+  while (true) {
+    const uint32_t start = micros();
+    esp_err_t res = httpd_resp_send_chunk(this->req_, data, len);
+
+    if (res == ESP_OK) {
+      this->pacer_.on_sent(len, micros() - start);
+      return ESP_OK;
+    }
+
+    if (res != ESP_ERR_HTTPD_RESP_SEND && res != ESP_ERR_TIMEOUT) {
       // Critical error (e.g., client closed socket)
       ESP_LOGE(TAG, "Critical send error: %s", esp_err_to_name(res));
-      this->reset_request_context_();
+      this->close_();
       return res;  // Immediate termination upon loss of connection
     }
+
+    // Buffer full: back off and give the TCP stack time for ACKs
+    uint32_t delay_ms;
+    if (!this->pacer_.on_congested(millis(), delay_ms)) {
+      ESP_LOGW(TAG, "Send deadline of %u ms exceeded, aborting response", (unsigned) this->route_->send_timeout_ms);
+      this->close_();
+      return res;
+    }
+
+    ESP_LOGD(TAG, "Chunk congestion, retrying in %u ms (%u B/s)", (unsigned) delay_ms,
+             (unsigned) this->pacer_.get_throughput());
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
   }
+}
 
-  // If we arrive here, the sending failed.
-  this->reset_request_context_();
-  return res;
+void RouteContext::set_status(const std::string &status) {
+  if (!this->check_request_()) {
+    return;
+  }
+
+  // Errors are not replayed from the cache, they describe this request only
+  if (this->capturing_ && status.compare(0, 1, "2") != 0) {
+    this->capturing_ = false;
+    std::string().swap(this->capture_body_);
+  }
+
+  this->status_ = status;
+  httpd_resp_set_status(this->req_, this->status_.c_str());
 }
 
-void WebServerRoutes::send_header(const std::string &field, const std::string &value) {
+void RouteContext::send_header(const std::string &field, const std::string &value) {
   if (!this->check_request_()) {
     return;
   }
 
-  for (size_t i = 0; i < current_headers_.size(); i += 2) {
-    if (auto current_value = has_header_(field); current_value) {
-      if (this->use_unique_header_fields_) {
-        // Prevent duplicate headers
-        ESP_LOGI(TAG, "HTTP Header field already set: '%s: %s' (New value '%s' will not be applied)", field.c_str(),
-                 current_value->c_str(), value.c_str());
-        return;
-      } else {
-        ESP_LOGI(TAG, "HTTP Header field already set: '%s: %s' (Add new value '%s')", field.c_str(),
-                 current_value->c_str(), value.c_str());
-      }
+  // Content-Length is sent by httpd_resp_send() itself; chunked responses must not carry it
+  if (strcasecmp(field.c_str(), "Content-Length") == 0) {
+    this->send_content_size(strtoull(value.c_str(), nullptr, 10));
+    return;
+  }
+
+  if (const char *current_value = this->find_header_(field.c_str()); current_value != nullptr) {
+    if (this->use_unique_header_fields_) {
+      // Prevent duplicate headers
+      ESP_LOGI(TAG, "HTTP Header field already set: '%s: %s' (New value '%s' will not be applied)", field.c_str(),
+               current_value, value.c_str());
+      return;
     }
+    ESP_LOGI(TAG, "HTTP Header field already set: '%s: %s' (Add new value '%s')", field.c_str(), current_value,
+             value.c_str());
+  }
+
+  // Field and value in one block with a stable address
+  std::unique_ptr<char[]> block(new (std::nothrow) char[field.size() + value.size() + 2]);
+  if (block == nullptr) {
+    ESP_LOGW(TAG, "Not enough memory for header %s", field.c_str());
+    return;
+  }
+  char *field_ptr = block.get();
+  char *value_ptr = field_ptr + field.size() + 1;
+  memcpy(field_ptr, field.c_str(), field.size() + 1);
+  memcpy(value_ptr, value.c_str(), value.size() + 1);
+
+  if (!this->add_header_(field_ptr, value_ptr)) {
+    return;
   }
+  this->header_strings_.push_back(std::move(block));
 
-  // Add field name
-  current_headers_.push_back(std::make_unique<std::string>(field));
-  const char *field_ptr = current_headers_.back()->c_str();
+  // The ETag is replayed through check_etag(), which also answers If-None-Match
+  if (this->capturing_ && strcasecmp(field_ptr, "ETag") != 0) {
+    this->capture_headers_.append(field_ptr, field.size() + 1);
+    this->capture_headers_.append(value_ptr, value.size() + 1);
+  }
+}
 
-  // Add value
-  current_headers_.push_back(std::make_unique<std::string>(value));
-  const char *value_ptr = current_headers_.back()->c_str();
+/**
+ * Registers a header whose strings outlive the request (flash or `header_strings_`).
+ */
+bool RouteContext::add_header_(const char *field, const char *value) {
+  if (this->header_count_ >= MAX_HEADERS) {
+    ESP_LOGW(TAG, "Too many headers, '%s' not applied", field);
+    return false;
+  }
 
   esp_err_t res = ESP_OK;
 
   // Register with ESP-IDF
-  if (strcasecmp(field_ptr, "Content-Type")) {
-    res = httpd_resp_set_hdr(this->current_req_, field_ptr, value_ptr);
+  if (strcasecmp(field, "Content-Type")) {
+    res = httpd_resp_set_hdr(this->req_, field, value);
   } else {
-    res = httpd_resp_set_type(this->current_req_, value_ptr);
+    res = httpd_resp_set_type(this->req_, value);
   }
 
   if (res != ESP_OK) {
-    ESP_LOGW(TAG, "Header [error]: %s [ %s ]", field_ptr, value_ptr);
+    ESP_LOGW(TAG, "Header [error]: %s [ %s ]", field, value);
     ESP_LOGW(TAG, "Set header failed: %s", esp_err_to_name(res));
-    return;
+    return false;
   }
 
-  ESP_LOGD(TAG, "Header [registered]: %s [ %s ]", field_ptr, value_ptr);
+  this->header_table_[this->header_count_++] = {field, value};
+  ESP_LOGD(TAG, "Header [registered]: %s [ %s ]", field, value);
+  return true;
 }
 
-void WebServerRoutes::send_content_size(size_t size) {  //
-  this->send_header("Content-Length", std::to_string(size));
+/**
+ * Announces the size of the body. The header itself is set by httpd_resp_send() when the body goes
+ * out in one piece (it fits into the output buffer, or is written with a single send_binary() of
+ * exactly this size). Chunked responses do not send it.
+ */
+void RouteContext::send_content_size(size_t size) {
+  if (this->encoder_ != nullptr) {
+    ESP_LOGD(TAG, "Content-Length skipped, the response is compressed");
+    return;
+  }
+  if (this->chunked_) {
+    ESP_LOGD(TAG, "Content-Length skipped, the response is already chunked");
+    return;
+  }
+  this->content_length_ = size;
 }
 
-void WebServerRoutes::send_content_type(const std::string &type) {  //
+void RouteContext::send_content_type(const std::string &type) {  //
   this->send_header("Content-Type", type);
 }
 
-void WebServerRoutes::send_content_disposition(const std::string &disposition) {  //
+void RouteContext::send_content_disposition(const std::string &disposition) {  //
   this->send_header("Content-Disposition", disposition);
 }
 
-void WebServerRoutes::send_filename(const std::string &filename) {
+void RouteContext::send_filename(const std::string &filename) {
   ESP_LOGI(TAG, "filename: %s", filename.c_str());
   ESP_LOGI(TAG, filename.c_str());
 
@@ -192,97 +672,807 @@ void WebServerRoutes::send_filename(const std::string &filename) {
   this->send_content_disposition(value);
 }
 
-std::string WebServerRoutes::get_query_param(const std::string &key) {
+bool RouteContext::check_etag(uint32_t validator) {
+  char etag[9];
+  snprintf(etag, sizeof(etag), "%08" PRIx32, validator);
+  return this->check_etag(std::string(etag));
+}
+
+bool RouteContext::check_etag(const std::string &etag) {
   if (!this->check_request_()) {
-    return "";
+    return false;
+  }
+  if (this->capturing_) {
+    this->capture_etag_ = etag;
   }
 
-  size_t query_len = httpd_req_get_url_query_len(this->current_req_);
-  if (query_len == 0) {
-    return "";
+  // The compressed representation is a different entity and needs its own tag
+  this->etag_ = "\"" + etag + (this->encoder_ != nullptr ? "-gz" : "") + "\"";
+  this->send_header("ETag", this->etag_);
+
+  if (!this->if_none_match_(this->etag_)) {
+    return false;
   }
 
-  char *query_str = new char[query_len + 1];
-  if (httpd_req_get_url_query_str(this->current_req_, query_str, query_len + 1) != ESP_OK) {
-    delete[] query_str;
-    return "";
+  ESP_LOGD(TAG, "Not modified: %s", this->etag_.c_str());
+  httpd_resp_set_status(this->req_, "304 Not Modified");
+  esp_err_t res = httpd_resp_send(this->req_, nullptr, 0);
+  if (res != ESP_OK) {
+    ESP_LOGW(TAG, "Sending 304 failed: %s", esp_err_to_name(res));
   }
+  this->finished_ = (res == ESP_OK);
+  this->close_();  // The response is complete, nothing else may be sent
+  return true;
+}
 
-  char value[query_len + 1];
-  esp_err_t res = httpd_query_key_value(query_str, key.c_str(), value, query_len + 1);
-  delete[] query_str;
+/**
+ * True if the If-None-Match header of the request lists `etag` (weak comparison) or is "*".
+ */
+bool RouteContext::if_none_match_(std::string_view etag) {
+  char header[256];
+  if (!this->get_request_header_("If-None-Match", header, sizeof(header))) {
+    return false;
+  }
 
-  if (res != ESP_OK) {
-    return "";
+  std::string_view list(header);
+  while (!list.empty()) {
+    const size_t comma = list.find(',');
+    std::string_view tag = list.substr(0, comma);
+    list = (comma == std::string_view::npos) ? std::string_view() : list.substr(comma + 1);
+
+    while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t'))
+      tag.remove_prefix(1);
+    while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t'))
+      tag.remove_suffix(1);
+    if (tag.substr(0, 2) == "W/")
+      tag.remove_prefix(2);
+
+    if (tag == "*" || tag == etag) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Enables gzip if the client accepts it (Accept-Encoding: gzip without q=0).
+ * Without memory for the encoder the response is sent uncompressed.
+ */
+bool RouteContext::negotiate_gzip_() {
+  this->send_header("Vary", "Accept-Encoding");
+
+  char header[128];
+  if (!this->get_request_header_("Accept-Encoding", header, sizeof(header))) {
+    return false;
+  }
+
+  bool accepted = false;
+  std::string_view list(header);
+  while (!list.empty() && !accepted) {
+    const size_t comma = list.find(',');
+    std::string_view coding = list.substr(0, comma);
+    list = (comma == std::string_view::npos) ? std::string_view() : list.substr(comma + 1);
+
+    const size_t semicolon = coding.find(';');
+    std::string_view params = (semicolon == std::string_view::npos) ? std::string_view() : coding.substr(semicolon);
+    coding = coding.substr(0, semicolon);
+    while (!coding.empty() && coding.front() == ' ')
+      coding.remove_prefix(1);
+    while (!coding.empty() && coding.back() == ' ')
+      coding.remove_suffix(1);
+    if (coding != "gzip") {
+      continue;
+    }
+
+    // "gzip;q=0" explicitly refuses it
+    const size_t q = params.find("q=");
+    accepted = (q == std::string_view::npos) || strtof(params.data() + q + 2, nullptr) > 0.0f;
+  }
+  if (!accepted) {
+    return false;
   }
 
-  return std::string(value);
+  auto encoder = std::unique_ptr<GzipEncoder>(new (std::nothrow)
+                                                  GzipEncoder(this->route_->gzip_window, OUTPUT_BUFFER_SIZE));
+  if (encoder == nullptr || !encoder->init()) {
+    ESP_LOGW(TAG, "Not enough memory for gzip (window %u), sending uncompressed", this->route_->gzip_window);
+    return false;
+  }
+  encoder->set_sink([this](const uint8_t *data, size_t len) {
+    return this->is_active() && this->write_raw_(reinterpret_cast<const char *>(data), len) == ESP_OK;
+  });
+  this->encoder_ = std::move(encoder);
+
+  this->send_header("Content-Encoding", "gzip");
+  return true;
 }
 
-std::string WebServerRoutes::get_key_value() {
+// Completes a compressed body (final block and gzip trailer)
+void RouteContext::finish_encoding_() {
+  if (this->encoder_ == nullptr || !this->is_active()) {
+    return;
+  }
+  this->encoder_->finish();
+  ESP_LOGD(TAG, "gzip: %u -> %u bytes", (unsigned) this->encoder_->get_bytes_in(),
+           (unsigned) this->encoder_->get_bytes_out());
+}
+
+// Copies a request header into `value`; false if it is missing or longer than `size` - 1
+bool RouteContext::get_request_header_(const char *field, char *value, size_t size) {
+  const size_t len = httpd_req_get_hdr_value_len(this->req_, field);
+  if (len == 0 || len >= size) {
+    return false;
+  }
+  return httpd_req_get_hdr_value_str(this->req_, field, value, size) == ESP_OK;
+}
+
+const QueryParams &RouteContext::query_params() {
+  if (!this->query_parsed_ && this->req_ != nullptr) {
+    this->query_.parse(this->req_->uri);
+    this->query_parsed_ = true;
+  }
+  return this->query_;
+}
+
+std::string RouteContext::get_query_param(const std::string &key) {
+  if (!this->check_request_()) {
+    return "";
+  }
+  return std::string(this->query_params().get(key));
+}
+
+std::string RouteContext::get_key_value() {
   if (!this->check_request_()) {
     return "";
   }
 
-  if (this->current_route_ == nullptr) {
+  if (this->route_ == nullptr) {
     ESP_LOGW(TAG, "Called outside of active request!");
     return "";
   }
 
-  std::string key = this->current_route_->key;
+  std::string key = this->route_->key;
   if (key.empty())
     return "";
 
   return this->get_query_param(key);
 }
 
-bool WebServerRoutes::check_request_() {
-  if (this->current_req_ == nullptr) {
+bool RouteContext::check_request_() {
+  if (this->req_ == nullptr) {
     ESP_LOGW(TAG, "Request method invoked without an active HTTP session.");
     return false;
   }
   return true;
 }
-void WebServerRoutes::reset_request_context_() {
-  this->current_req_ = nullptr;
-  this->current_route_ = nullptr;
-  this->is_busy_ = false;
-  this->current_headers_.clear();
+// Called after a send error: the request must not be used anymore
+void RouteContext::close_() { this->req_ = nullptr; }
+
+/**
+ * Applies the concurrency cap and the rate limits before anything else runs.
+ * Rejected requests get a short `429 Too Many Requests` with Retry-After.
+ */
+bool WebServerRoutes::admit_(httpd_req_t *req, RouteEntry &route) {
+  uint32_t retry_after_ms = 1000;
+  const char *reason = nullptr;
+  const uint32_t now = millis();
+
+  // Counted until release_(); the cheapest check comes first. A request rejected by the route
+  // does not use up a global token, and one rejected globally gives its route token back.
+  const uint8_t in_flight = route.in_flight.fetch_add(1);
+  if (route.max_concurrent > 0 && in_flight >= route.max_concurrent) {
+    reason = "concurrency";
+  } else if (!route.rate_limit.try_acquire(now, retry_after_ms)) {
+    reason = "route rate";
+  } else if (!this->rate_limit_.try_acquire(now, retry_after_ms)) {
+    route.rate_limit.refund();
+    reason = "global rate";
+  }
+
+  if (reason == nullptr) {
+    return true;
+  }
+  route.in_flight--;
+
+  this->rejected_requests_++;
+  ESP_LOGD(TAG, "Rejected %s (%s limit), retry after %u ms", req->uri, reason, (unsigned) retry_after_ms);
+
+  char retry_after[12];
+  snprintf(retry_after, sizeof(retry_after), "%u", (unsigned) std::max<uint32_t>(1, (retry_after_ms + 999) / 1000));
+  httpd_resp_set_status(req, "429 Too Many Requests");
+  httpd_resp_set_hdr(req, "Retry-After", retry_after);
+  httpd_resp_set_type(req, "text/plain");
+  esp_err_t res = httpd_resp_send(req, "Too Many Requests", HTTPD_RESP_USE_STRLEN);
+  if (res != ESP_OK) {
+    ESP_LOGW(TAG, "Sending 429 failed: %s", esp_err_to_name(res));
+  }
+  return false;
+}
+
+void WebServerRoutes::release_(RouteEntry &route) { route.in_flight--; }
+
+// True for a Connection header (request or response) that asks to close the connection
+static bool closes_connection(const char *value) { return value != nullptr && strcasecmp(value, "close") == 0; }
+
+// Identifies the connection behind a socket, 0 if it is gone
+static uint32_t peer_key(int fd) {
+  sockaddr_storage addr{};
+  socklen_t len = sizeof(addr);
+  if (getpeername(fd, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+    return 0;
+  }
+
+  uint32_t hash = 2166136261UL;  // FNV-1a over address and port
+  const auto *bytes = reinterpret_cast<const uint8_t *>(&addr);
+  for (socklen_t i = 0; i < len; i++) {
+    hash = (hash ^ bytes[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+/**
+ * Decides whether the connection stays open after the response (keep-alive mode only) and sets
+ * the headers that tell the client. The route or the client can ask for `Connection: close`.
+ */
+bool WebServerRoutes::begin_connection_(httpd_req_t *req, RouteContext &context) {
+  if (!this->connections_.is_enabled()) {
+    return false;
+  }
+  this->httpd_ = req->handle;
+
+  char request_connection[32];
+  const char *connection = context.find_header_("Connection");
+  const bool close = closes_connection(connection) ||
+                     (context.get_request_header_("Connection", request_connection, sizeof(request_connection)) &&
+                      closes_connection(request_connection));
+
+  if (!close) {
+    const int fd = httpd_req_to_sockfd(req);
+    int evicted;
+    if (this->connections_.acquire(fd, peer_key(fd), millis(), evicted)) {
+      if (evicted >= 0) {
+        ESP_LOGD(TAG, "Closing idle connection %d for %d", evicted, fd);
+        httpd_sess_trigger_close(req->handle, evicted);
+      }
+
+      char keep_alive[24];
+      snprintf(keep_alive, sizeof(keep_alive), "timeout=%u",
+               (unsigned) std::max<uint32_t>(1, this->connections_.get_idle_timeout() / 1000));
+      context.send_header("Keep-Alive", keep_alive);
+      return true;
+    }
+    ESP_LOGD(TAG, "All connections busy, closing %d after the response", fd);
+  }
+
+  if (!closes_connection(connection)) {
+    context.add_header_("Connection", "close");  // Added to a "keep-alive" from the route, close wins
+  }
+  return false;
+}
+
+// The response is over: the connection waits for the next request or is closed
+void WebServerRoutes::end_connection_(httpd_req_t *req, bool keep_alive) {
+  const int fd = httpd_req_to_sockfd(req);
+  if (keep_alive) {
+    this->connections_.release(fd, millis());
+    return;
+  }
+  this->connections_.remove(fd);
+  httpd_sess_trigger_close(req->handle, fd);
+}
+
+// Closes connections idle for longer than the timeout; queued once a second, runs in the httpd task
+void WebServerRoutes::expire_connections_(void *arg) {
+  auto *self = static_cast<WebServerRoutes *>(arg);
+  httpd_handle_t httpd = self->httpd_.load();
+  self->connections_.expire(
+      millis(), [](int fd, uint32_t peer) { return peer_key(fd) == peer; },
+      [httpd](int fd) {
+        ESP_LOGD(TAG, "Closing idle connection %d", fd);
+        httpd_sess_trigger_close(httpd, fd);
+      });
 }
 
 void WebServerRoutes::handle_native_request_(httpd_req_t *req, RouteEntry &route) {
-  this->current_req_ = req;
-  this->current_route_ = &route;
-  this->is_busy_ = true;
+  if (!this->admit_(req, route)) {
+    return;
+  }
+  this->active_requests_++;
 
+  RouteContext context(req, &route, this->use_unique_header_fields_);
+
+  // Headers set at runtime override those from YAML with the same field
   for (auto &item : route.headers) {
     if (!item.second.empty()) {
-      this->send_header(item.first, item.second);
+      context.send_header(item.first, item.second);
+    }
+  }
+  for (size_t i = 0; i < route.static_header_count; i++) {
+    const StaticHeader &header = route.static_headers[i];
+    if (context.find_header_(header.field) == nullptr) {
+      context.add_header_(header.field, header.value);
     }
   }
 
-  route.execute_(*this);
+  if (route.gzip_window > 0) {
+    context.negotiate_gzip_();
+  }
+  context.keep_alive_ = this->begin_connection_(req, context);
 
-  esp_err_t res = httpd_resp_send_chunk(req, nullptr, 0);
-  if (res != ESP_OK) {
-    ESP_LOGW(TAG, "Final chunk failed: %s", esp_err_to_name(res));
+  if (route.cache_ttl_ms > 0) {
+    if (this->cache_clear_requested_.exchange(false)) {
+      this->cache_.clear();
+    }
+
+    if (const auto *entry = this->cache_.find(req->uri, millis()); entry != nullptr) {
+      ESP_LOGD(TAG, "Cache hit: %s", req->uri);
+      this->cache_hits_++;
+      context.replay_(*entry);
+    } else {
+      this->cache_misses_++;
+      context.start_capture_(this->cache_.max_entry_size());
+      route.execute_(context);
+    }
+  } else {
+    route.execute_(context);
+  }
+
+  if (context.stream_producer_ && context.is_active()) {
+    context.flush_();
+    if (this->start_stream_(context)) {
+      this->record_send_stats_(context.pacer_);
+      return;  // The stream job completes the request (and releases the route)
+    }
+    context.run_stream_();
+  }
+
+  const bool complete = context.end_response_();
+
+  // Only complete responses are cached (no errors, 304 or streams)
+  if (context.capturing_ && context.is_active() && complete) {
+    this->cache_.insert(req->uri, millis() + route.cache_ttl_ms, context.status_, std::move(context.capture_headers_),
+                        std::move(context.capture_etag_), context.capture_body_);
+    context.capturing_ = false;
+  }
+
+  // A truncated body can only be told to the client by closing the connection
+  if (!complete || this->connections_.is_enabled()) {
+    const bool keep_alive = context.keep_alive_ && !closes_connection(context.find_header_("Connection"));
+    this->end_connection_(req, keep_alive && complete);
+  }
+
+  this->record_send_stats_(context.pacer_);
+  release_(route);
+  this->active_requests_--;
+}
+
+void RouteContext::start_capture_(size_t limit) {
+  this->capturing_ = true;
+  this->capture_limit_ = limit;
+}
+
+// Sends a cached response instead of running the lambda
+void RouteContext::replay_(const ResponseCache::Entry &entry) {
+  if (!entry.status.empty()) {
+    this->set_status(entry.status);
+  }
+
+  const char *pos = entry.headers.data();
+  const char *end = pos + entry.headers.size();
+  while (pos < end) {
+    const char *field = pos;
+    const char *value = field + strlen(field) + 1;
+    pos = value + strlen(value) + 1;
+    this->send_header(field, value);
+  }
+
+  if (!entry.etag.empty() && this->check_etag(entry.etag)) {
+    return;  // 304 Not Modified
+  }
+  if (entry.body_len > 0) {
+    this->send_binary(reinterpret_cast<const char *>(entry.body), entry.body_len);
+  }
+}
+
+void WebServerRoutes::record_send_stats_(const SendPacer &pacer) {
+  this->send_retries_ += pacer.get_retries();
+  this->send_stalls_ += pacer.get_stalls();
+  this->send_timeouts_ += pacer.get_timeouts();
+}
+
+void RouteContext::stream(stream_producer_t producer, size_t chunk_size) {
+  if (!this->check_request_()) {
+    return;
+  }
+
+  this->stream_producer_ = std::move(producer);
+  this->capturing_ = false;  // Streamed bodies are not cached
+  this->stream_chunk_size_ = chunk_size > 0 ? chunk_size : 1024;
+}
+
+/**
+ * Parses a single range "bytes=first-last", "bytes=first-" or "bytes=-suffix" against a body of
+ * `total` bytes (`last` inclusive).
+ * @return 1 for a satisfiable range, 0 if it lies outside the body, -1 if the header is ignored
+ * (malformed or several ranges, which are answered with the full body).
+ */
+static int parse_byte_range(std::string_view spec, size_t total, size_t &first, size_t &last) {
+  if (spec.substr(0, 6) != "bytes=" || spec.find(',') != std::string_view::npos) {
+    return -1;
+  }
+  spec.remove_prefix(6);
+
+  const size_t dash = spec.find('-');
+  if (dash == std::string_view::npos) {
+    return -1;
+  }
+
+  auto parse_number = [](std::string_view text, size_t &value) {
+    if (text.empty() || text.size() > 9) {  // No overflow with a 32 bit size_t
+      return false;
+    }
+    value = 0;
+    for (char c : text) {
+      if (c < '0' || c > '9') {
+        return false;
+      }
+      value = value * 10 + (c - '0');
+    }
+    return true;
+  };
+
+  std::string_view first_text = spec.substr(0, dash);
+  std::string_view last_text = spec.substr(dash + 1);
+
+  if (first_text.empty()) {
+    // Suffix range: the last n bytes
+    size_t suffix;
+    if (!parse_number(last_text, suffix)) {
+      return -1;
+    }
+    if (suffix == 0 || total == 0) {
+      return 0;
+    }
+    first = (suffix < total) ? total - suffix : 0;
+    last = total - 1;
+    return 1;
+  }
+
+  if (!parse_number(first_text, first)) {
+    return -1;
+  }
+  if (last_text.empty()) {
+    last = total - 1;
+  } else if (!parse_number(last_text, last) || last < first) {
+    return -1;
   }
 
-  this->reset_request_context_();
+  if (first >= total) {
+    return 0;
+  }
+  last = std::min(last, total - 1);
+  return 1;
 }
 
-std::optional<std::string> WebServerRoutes::has_header_(const std::string &field) const {
-  for (auto it = current_headers_.begin(); it != current_headers_.end(); ++it) {
-    if (*it != nullptr && strcasecmp((*it)->c_str(), field.c_str()) == 0) {
-      auto next_it = std::next(it);
+void RouteContext::stream_seekable(size_t total_size, seekable_producer_t producer, size_t chunk_size) {
+  if (!this->check_request_()) {
+    return;
+  }
+
+  size_t first = 0;
+  size_t last = total_size - 1;
+  int range = -1;
+
+  // Ranges of a compressed body would refer to the compressed bytes, which are not seekable
+  if (this->encoder_ == nullptr) {
+    this->send_header("Accept-Ranges", "bytes");
+  }
 
-      if (next_it != current_headers_.end() && *next_it != nullptr) {
-        return *(*next_it);
+  char header[64];
+  if (this->encoder_ == nullptr && this->get_request_header_("Range", header, sizeof(header))) {
+    range = parse_byte_range(header, total_size, first, last);
+
+    // A resumed download must not mix two versions of the content
+    char if_range[64];
+    if (range >= 0 && this->get_request_header_("If-Range", if_range, sizeof(if_range)) &&
+        this->etag_ != if_range) {
+      range = -1;
+    }
+  }
+
+  if (range == 0) {
+    ESP_LOGD(TAG, "Range not satisfiable: %s (%zu bytes)", header, total_size);
+    char content_range[32];
+    snprintf(content_range, sizeof(content_range), "bytes */%zu", total_size);
+    this->send_header("Content-Range", content_range);
+    httpd_resp_set_status(this->req_, "416 Range Not Satisfiable");
+    esp_err_t res = httpd_resp_send(this->req_, nullptr, 0);
+    if (res != ESP_OK) {
+      ESP_LOGW(TAG, "Sending 416 failed: %s", esp_err_to_name(res));
+    }
+    this->finished_ = (res == ESP_OK);
+    this->close_();  // The response is complete, nothing else may be sent
+    return;
+  }
+
+  if (range == 1) {
+    ESP_LOGD(TAG, "Range: %zu-%zu/%zu", first, last, total_size);
+    char content_range[48];
+    snprintf(content_range, sizeof(content_range), "bytes %zu-%zu/%zu", first, last, total_size);
+    this->send_header("Content-Range", content_range);
+    httpd_resp_set_status(this->req_, "206 Partial Content");
+  } else {
+    first = 0;
+    last = total_size - 1;
+  }
+
+  // Position and remaining length live in the copy held by the stream
+  size_t offset = first;
+  size_t remaining = (total_size > 0) ? last - first + 1 : 0;
+  this->stream(
+      [producer = std::move(producer), offset, remaining](char *buffer, size_t size) mutable -> int {
+        if (remaining == 0) {
+          return STREAM_END;
+        }
+        int len = producer(offset, buffer, std::min(size, remaining));
+        if (len > 0) {
+          len = std::min<size_t>(len, remaining);
+          offset += len;
+          remaining -= len;
+        }
+        return len;
+      },
+      chunk_size);
+}
+
+// Fallback without async handlers: pulls the producer within the request handler
+void RouteContext::run_stream_() {
+  std::unique_ptr<char[]> buffer(new (std::nothrow) char[this->stream_chunk_size_]);
+  if (buffer == nullptr) {
+    ESP_LOGE(TAG, "Not enough memory for a stream buffer of %zu bytes", this->stream_chunk_size_);
+    return;
+  }
+
+  while (this->is_active()) {
+    int len = this->stream_producer_(buffer.get(), this->stream_chunk_size_);
+    if (len == STREAM_PENDING) {
+      vTaskDelay(pdMS_TO_TICKS(STREAM_RETRY_MS));
+      continue;
+    }
+    if (len <= 0) {
+      break;
+    }
+    this->send_binary(buffer.get(), std::min<size_t>(len, this->stream_chunk_size_));
+  }
+  this->flush_();
+}
+
+/**
+ * A streamed response that outlives its request handler.
+ * Holds the async copy of the request and the header strings it points to.
+ */
+struct WebServerRoutes::StreamJob {
+  WebServerRoutes *parent;
+  RouteEntry *route;
+  httpd_req_t *req{nullptr};
+  RouteContext::stream_producer_t producer;
+  std::vector<std::unique_ptr<char[]>> headers;
+  std::unique_ptr<GzipEncoder> encoder;
+  std::unique_ptr<char[]> buffer;
+  size_t size;
+  esp_timer_handle_t retry_timer{nullptr};
+  bool keep_alive{false};
+
+  SendPacer pacer;
+  std::string out;            // Compressed data of the current step (gzip only)
+  const char *data{nullptr};  // Produced data not sent yet
+  size_t pending{0};
+  bool draining{false};  // Producer finished, the encoder's remaining output is being sent
+  bool failed{false};    // Queueing from the retry timer failed, the next step aborts
+};
+
+/**
+ * Hands a streamed response over to the httpd task.
+ * @return false if the request has to be streamed inline (no async support or out of memory).
+ */
+bool WebServerRoutes::start_stream_(RouteContext &context) {
+#ifdef WEB_SERVER_ROUTES_ASYNC_STREAM
+  auto job = std::make_unique<StreamJob>();
+  job->parent = this;
+  job->route = context.route_;
+  job->size = context.stream_chunk_size_;
+  job->keep_alive = context.keep_alive_;
+  job->pacer.set_deadline(context.route_->send_timeout_ms);
+  job->buffer.reset(new (std::nothrow) char[job->size]);
+  if (job->buffer == nullptr) {
+    return false;
+  }
+
+  esp_timer_create_args_t timer_args{};
+  timer_args.callback = &WebServerRoutes::stream_retry_;
+  timer_args.arg = job.get();
+  timer_args.name = "wsr_stream";
+  if (esp_timer_create(&timer_args, &job->retry_timer) != ESP_OK) {
+    return false;
+  }
+
+  if (httpd_req_async_handler_begin(context.req_, &job->req) != ESP_OK) {
+    ESP_LOGW(TAG, "Async request not available, streaming inline");
+    esp_timer_delete(job->retry_timer);
+    return false;
+  }
+
+  // The async copy owns the request from now on
+  job->producer = std::move(context.stream_producer_);
+  job->headers = std::move(context.header_strings_);
+  job->encoder = std::move(context.encoder_);
+  context.req_ = nullptr;
+
+  if (job->encoder != nullptr) {
+    StreamJob *target = job.get();
+    job->encoder->set_sink([target](const uint8_t *data, size_t len) {
+      target->out.append(reinterpret_cast<const char *>(data), len);
+      return true;
+    });
+  }
+
+  StreamJob *raw = job.release();
+  if (httpd_queue_work(raw->req->handle, &WebServerRoutes::stream_step_, raw) != ESP_OK) {
+    finish_stream_(raw, false);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Sends one chunk of a stream job; runs in the httpd task.
+ * The next step is queued behind the work of other connections instead of looping here. Produced
+ * data is sent in pieces of the pacer's chunk size; a congested send is retried from the retry
+ * timer after the pacer's backoff, until the route's send_timeout is exceeded.
+ */
+void WebServerRoutes::stream_step_(void *arg) {
+  auto *job = static_cast<StreamJob *>(arg);
+
+  if (job->failed) {
+    ESP_LOGW(TAG, "Stream aborted: work queue of the web server was full");
+    finish_stream_(job, false);
+    return;
+  }
+
+  if (job->pending == 0) {
+    if (job->draining) {
+      finish_stream_(job, true);
+      return;
+    }
+
+    int len = job->producer(job->buffer.get(), job->size);
+    if (len == RouteContext::STREAM_PENDING) {
+      // Nothing ready yet: ask again later instead of spinning in the httpd task
+      if (esp_timer_start_once(job->retry_timer, STREAM_RETRY_MS * 1000) != ESP_OK) {
+        finish_stream_(job, false);
+      }
+      return;
+    }
+
+    if (len <= 0 && job->encoder == nullptr) {
+      finish_stream_(job, true);
+      return;
+    }
+
+    const size_t count = std::min<size_t>(std::max(len, 0), job->size);
+    if (job->encoder != nullptr) {
+      // The encoder's output collects in `out` and is sent like any other data
+      job->out.clear();
+      bool ok;
+      if (len <= 0) {
+        ok = job->encoder->finish();
+        job->draining = true;
+      } else {
+        ok = job->encoder->write(reinterpret_cast<const uint8_t *>(job->buffer.get()), count);
+      }
+      if (!ok) {
+        ESP_LOGW(TAG, "Stream aborted: compression failed");
+        finish_stream_(job, false);
+        return;
+      }
+      job->data = job->out.data();
+      job->pending = job->out.size();
+    } else {
+      job->data = job->buffer.get();
+      job->pending = count;
+    }
+    job->pacer.begin(millis());
+  }
+
+  if (job->pending > 0) {
+    const size_t chunk = std::min(job->pending, job->pacer.chunk_size());
+    const uint32_t start = micros();
+    esp_err_t res = httpd_resp_send_chunk(job->req, job->data, chunk);
+
+    if (res == ESP_ERR_HTTPD_RESP_SEND || res == ESP_ERR_TIMEOUT) {
+      // Buffer full: try the same data again after the backoff
+      uint32_t delay_ms;
+      if (!job->pacer.on_congested(millis(), delay_ms)) {
+        ESP_LOGW(TAG, "Send deadline of %u ms exceeded, aborting stream", (unsigned) job->route->send_timeout_ms);
+        finish_stream_(job, false);
+        return;
+      }
+      ESP_LOGD(TAG, "Stream congestion, retrying in %u ms (%u B/s)", (unsigned) delay_ms,
+               (unsigned) job->pacer.get_throughput());
+      if (esp_timer_start_once(job->retry_timer, delay_ms * 1000) != ESP_OK) {
+        finish_stream_(job, false);
       }
-      return std::nullopt;
+      return;
+    }
+    if (res != ESP_OK) {
+      ESP_LOGW(TAG, "Stream aborted: %s", esp_err_to_name(res));
+      finish_stream_(job, false);
+      return;
+    }
+
+    job->pacer.on_sent(chunk, micros() - start);
+    job->data += chunk;
+    job->pending -= chunk;
+    if (job->pending > 0) {
+      job->pacer.begin(millis());
+    }
+  }
+
+  if (httpd_queue_work(job->req->handle, &WebServerRoutes::stream_step_, job) != ESP_OK) {
+    finish_stream_(job, false);
+  }
+}
+
+/**
+ * Retry timer of a pending producer or a congested send (esp_timer task).
+ * The job must only be finished in the httpd task, which owns the connection table: if the work
+ * cannot be queued, the job is marked failed and queueing is retried, so the next step aborts it.
+ */
+void WebServerRoutes::stream_retry_(void *arg) {
+  auto *job = static_cast<StreamJob *>(arg);
+  if (httpd_queue_work(job->req->handle, &WebServerRoutes::stream_step_, job) == ESP_OK) {
+    return;
+  }
+
+  job->failed = true;
+  if (esp_timer_start_once(job->retry_timer, STREAM_RETRY_MS * 1000) != ESP_OK) {
+    ESP_LOGE(TAG, "Stream could not be queued, request %p left open", job->req);
+  }
+}
+
+void WebServerRoutes::finish_stream_(StreamJob *job, bool complete) {
+#ifdef WEB_SERVER_ROUTES_ASYNC_STREAM
+  if (complete) {
+    esp_err_t res = httpd_resp_send_chunk(job->req, nullptr, 0);
+    if (res != ESP_OK) {
+      ESP_LOGW(TAG, "Final chunk failed: %s", esp_err_to_name(res));
+      complete = false;
+    }
+  }
+
+  // The body is incomplete: closing the connection is the only way to tell the client
+  if (!complete || job->parent->connections_.is_enabled()) {
+    job->parent->end_connection_(job->req, job->keep_alive && complete);
+  }
+
+  httpd_req_async_handler_complete(job->req);
+#endif
+  esp_timer_delete(job->retry_timer);
+  job->parent->record_send_stats_(job->pacer);
+  release_(*job->route);
+  job->parent->active_requests_--;
+  delete job;
+}
+
+const char *RouteContext::find_header_(const char *field) const {
+  for (size_t i = 0; i < this->header_count_; i++) {
+    if (strcasecmp(this->header_table_[i].field, field) == 0) {
+      return this->header_table_[i].value;
     }
   }
-  return std::nullopt;
+  return nullptr;
 }
 
 }  // namespace web_server_routes
@@ -16,11 +16,21 @@
 #include "esphome/core/log.h"
 #include "esphome/components/web_server_base/web_server_base.h"
 #include "esphome/components/web_server_idf/web_server_idf.h"
+#include "gzip_encoder.h"
+#include "connection_table.h"
+#include "query_params.h"
+#include "response_cache.h"
+#include "send_pacer.h"
+#include "token_bucket.h"
 #include <esp_http_server.h>
+#include <array>
+#include <atomic>
+#include <cstring>
 #include <functional>
 #include <list>
-#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace esphome {
@@ -29,11 +39,21 @@ namespace web_server_routes {
 static const char *const TAG = "web_server_routes";
 
 class WebServerRoutes;
+class RouteContext;
+
+/**
+ * A header known at compile time. Generated by __init__.py as a static const array,
+ * so field and value are string literals in flash and are passed to ESP-IDF as they are.
+ */
+struct StaticHeader {
+  const char *field;
+  const char *value;
+};
 
 class WebServerRoutes : public Component {
  public:
   struct RouteEntry {
-    using route_action_t = std::function<void(WebServerRoutes &)>;
+    using route_action_t = std::function<void(RouteContext &)>;
 
     RouteEntry(std::string id, std::string path, std::string key, route_action_t action)
         : id(id), path(path), key(key), action_(std::move(action)) {}
@@ -41,10 +61,27 @@ class WebServerRoutes : public Component {
     std::string id;
     std::string path;
     std::string key;
-    std::vector<std::pair<std::string, std::string>> headers;
+    std::vector<std::pair<std::string, std::string>> headers;  // Set at runtime, take precedence
+    const StaticHeader *static_headers{nullptr};                // From YAML, validated and deduplicated
+    size_t static_header_count{0};
     route_action_t action_;
+    uint32_t send_timeout_ms{2000};  // Deadline for a congested chunk (see SendPacer)
+    uint16_t gzip_window{0};         // Window of the gzip encoder, 0 = no compression
+    uint32_t cache_ttl_ms{0};        // Responses are replayed from the cache this long, 0 = no caching
+    TokenBucket rate_limit;          // Disabled unless configured
+    uint8_t max_concurrent{0};       // Requests answered at the same time, 0 = unlimited
+    std::atomic<uint8_t> in_flight{0};
 
     void set_responder(route_action_t action) { this->action_ = std::move(action); }
+    void set_send_timeout(uint32_t timeout_ms) { this->send_timeout_ms = timeout_ms; }
+    void set_gzip_window(uint16_t window) { this->gzip_window = window; }
+    void set_cache_ttl(uint32_t ttl_ms) { this->cache_ttl_ms = ttl_ms; }
+    void set_rate_limit(float rate, uint32_t burst) { this->rate_limit.configure(rate, burst); }
+    void set_max_concurrent(uint8_t max_concurrent) { this->max_concurrent = max_concurrent; }
+    void set_static_headers(const StaticHeader *headers, size_t count) {
+      this->static_headers = headers;
+      this->static_header_count = count;
+    }
 
     void set_content_type(std::string content_type) {  //
       set_header("Content-Type", content_type);
@@ -65,6 +102,11 @@ class WebServerRoutes : public Component {
           return item.second;  // Return the first match found
         }
       }
+      for (size_t i = 0; i < this->static_header_count; i++) {
+        if (strcasecmp(this->static_headers[i].field, field.c_str()) == 0) {
+          return this->static_headers[i].value;
+        }
+      }
       return "";
     }
 
@@ -105,7 +147,7 @@ class WebServerRoutes : public Component {
       }
     }
 
-    void execute_(WebServerRoutes &it) {
+    void execute_(RouteContext &it) {
       if (this->action_) {
         this->action_(it);
       }
@@ -142,24 +184,17 @@ class WebServerRoutes : public Component {
     explicit RouteHandler(WebServerRoutes *parent) : parent_(parent) {}
 
     bool canHandle(esphome::web_server_idf::AsyncWebServerRequest *request) const override {
-      std::string url = request->url();
-      for (auto &route_ptr : this->parent_->routes_) {
-        auto &route = *route_ptr;
-        if (url == route.path || url == route.path + "/") {
-          if (route.key.empty() || request->hasParam(route.key)) {
-            // Log handled route
-            ESP_LOGI(TAG, "Path: %s", url.c_str());
-            if (!route.key.empty()) {
-              ESP_LOGI(TAG, "Key: %s", route.key.c_str());
-            }
-
-            this->matched_route_ = &route;
-            return true;
-          }
+      httpd_req_t *net_req = *request;
+      RouteEntry *route = (net_req != nullptr) ? this->parent_->find_route_(net_req->uri) : nullptr;
+
+      if (route != nullptr) {
+        // Log handled route
+        ESP_LOGI(TAG, "Path: %s", route->path.c_str());
+        if (!route->key.empty()) {
+          ESP_LOGI(TAG, "Key: %s", route->key.c_str());
         }
       }
-      this->matched_route_ = nullptr;
-      return false;
+      return route != nullptr;
     }
 
     void handleRequest(esphome::web_server_idf::AsyncWebServerRequest *request) override {
@@ -168,14 +203,15 @@ class WebServerRoutes : public Component {
         return;
       }
 
-      if (this->matched_route_ == nullptr) {
-        ESP_LOGW(TAG, "No matched route for URL %s", request->url().c_str());
+      httpd_req_t *net_req = *request;
+      if (net_req == nullptr) {
         return;
       }
 
-      httpd_req_t *net_req = *request;
-      if (net_req == nullptr) {
-        this->matched_route_ = nullptr;  // Cleanup before exiting
+      // Resolved again instead of remembered from canHandle(): the handler is shared by all requests
+      RouteEntry *route = this->parent_->find_route_(net_req->uri);
+      if (route == nullptr) {
+        ESP_LOGW(TAG, "No matched route for URL %s", net_req->uri);
         return;
       }
 
@@ -190,53 +226,266 @@ class WebServerRoutes : public Component {
       }
 #endif  // ESPHOME_LOG_LEVEL_DEBUG
 
-      this->parent_->handle_native_request_(net_req, *(this->matched_route_));
-      this->matched_route_ = nullptr;
+      this->parent_->handle_native_request_(net_req, *route);
     }
 
    protected:
     WebServerRoutes *parent_;
-    mutable RouteEntry *matched_route_{nullptr};  // mutable allows assignment within the const method canHandle
   };
 
   void set_web_server_base(web_server_base::WebServerBase *base) { this->base_ = base; }
   RouteEntry *add_route(RouteEntry *route);
   float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
   void setup() override;
-  bool is_transmitting() { return this->is_busy_; }
+  bool is_transmitting() const { return this->active_requests_.load() > 0; }
+  uint8_t get_active_requests() const { return this->active_requests_.load(); }
+
+  // Congestion counters of all requests so far (see SendPacer)
+  uint32_t get_send_retries() const { return this->send_retries_.load(); }
+  uint32_t get_send_stalls() const { return this->send_stalls_.load(); }
+  uint32_t get_send_timeouts() const { return this->send_timeouts_.load(); }
+  void set_unique_header_fields(const bool state) { this->use_unique_header_fields_ = state; }
+
+  // Limit of all routes together (requests per second, burst)
+  void set_rate_limit(float rate, uint32_t burst) { this->rate_limit_.configure(rate, burst); }
+  uint32_t get_rejected_requests() const { return this->rejected_requests_.load(); }
+
+  // Keep-alive mode: connections stay open for further requests (see ConnectionTable)
+  void set_keep_alive(uint32_t idle_timeout_ms, uint8_t max_connections) {
+    this->connections_.configure(idle_timeout_ms, max_connections);
+  }
+
+  // Response cache of routes with `cache_ttl`
+  void set_cache_size(size_t bytes) { this->cache_.set_capacity(bytes); }
+  uint32_t get_cache_hits() const { return this->cache_hits_.load(); }
+  uint32_t get_cache_misses() const { return this->cache_misses_.load(); }
+  // Drops all cached responses (e.g. after the data changed); safe to call from any task
+  void clear_cache() { this->cache_clear_requested_ = true; }
+
+ protected:
+  struct StreamJob;
+
+  void handle_native_request_(httpd_req_t *req, RouteEntry &route);
+  bool admit_(httpd_req_t *req, RouteEntry &route);
+  static void release_(RouteEntry &route);
+  bool begin_connection_(httpd_req_t *req, RouteContext &context);
+  void end_connection_(httpd_req_t *req, bool keep_alive);
+  static void expire_connections_(void *arg);
+  void record_send_stats_(const SendPacer &pacer);
+  void index_route_(RouteEntry *route);
+  RouteEntry *find_route_(const char *uri) const;
+
+  // Streamed responses (see RouteContext::stream())
+  bool start_stream_(RouteContext &context);
+  static void stream_step_(void *arg);
+  static void stream_retry_(void *arg);
+  static void finish_stream_(StreamJob *job, bool complete);
+
+  web_server_base::WebServerBase *base_;
+  std::vector<std::unique_ptr<RouteEntry>> routes_;
+
+  /**
+   * Routes per normalized path, routes with a key before the fallback route without one.
+   * Keys are views of RouteEntry::path, which lives as long as the route itself.
+   */
+  std::unordered_map<std::string_view, std::vector<RouteEntry *>> route_index_;
+  std::atomic<uint8_t> active_requests_{0};  // Requests currently being answered
+  std::atomic<uint32_t> send_retries_{0};
+  std::atomic<uint32_t> send_stalls_{0};
+  std::atomic<uint32_t> send_timeouts_{0};
+  bool use_unique_header_fields_{true};
+
+  TokenBucket rate_limit_;
+  std::atomic<uint32_t> rejected_requests_{0};
+
+  ConnectionTable connections_;                 // Only used by the httpd task
+  std::atomic<httpd_handle_t> httpd_{nullptr};  // For queueing the idle check, set by the first request
+
+  ResponseCache cache_;  // Only used by the httpd task
+  std::atomic<uint32_t> cache_hits_{0};
+  std::atomic<uint32_t> cache_misses_{0};
+  std::atomic<bool> cache_clear_requested_{false};
+};
+
+/**
+ * State of one request in flight, passed to the route lambda as `it`.
+ * Every request gets its own context, so requests handled by different httpd tasks
+ * do not share any send or header state.
+ */
+class RouteContext {
+ public:
+  RouteContext(httpd_req_t *req, WebServerRoutes::RouteEntry *route, bool unique_header_fields)
+      : req_(req), route_(route), use_unique_header_fields_(unique_header_fields) {
+    this->pacer_.set_deadline(route->send_timeout_ms);
+  }
+
+  // ESP-IDF keeps pointers to the header strings, the context must stay where ESP-IDF saw it
+  RouteContext(const RouteContext &) = delete;
+  RouteContext &operator=(const RouteContext &) = delete;
 
   esp_err_t send(const std::string &data);
   esp_err_t send(const char *format, ...);  // Sends a formatted string using variadic arguments
   esp_err_t send_binary(const char *data, size_t len);
 
+  // Typed writers without format parsing (output goes to the same buffer as send())
+  esp_err_t send_int(int32_t value);
+  esp_err_t send_uint(uint32_t value);
+  esp_err_t send_float(float value, uint8_t decimals = 2);  // NaN and infinity are sent as `null`
+  esp_err_t send_escaped(std::string_view text);           // Escaped for use inside a JSON string
+
+  /**
+   * Sends buffered data now. Small writes are collected and go out as chunks that fill one
+   * TCP segment; the buffer is flushed automatically when the lambda returns.
+   * With gzip, flush() also makes everything sent so far decodable by the client.
+   */
+  esp_err_t flush();
+
+  bool is_compressed() const { return this->encoder_ != nullptr; }
+
+  /**
+   * Sets the status line of the response, e.g. "404 Not Found" (default "200 OK"). Call it
+   * before anything is sent. With `cache_ttl`, only 2xx responses are cached.
+   */
+  void set_status(const std::string &status);
+
   void send_header(const std::string &field, const std::string &value);  // Sets HTTP headers
   void send_content_size(size_t size);
   void send_content_type(const std::string &type);
   void send_content_disposition(const std::string &disposition);
   void send_filename(const std::string &filename);
+
+  /**
+   * Conditional response: sets the ETag of the response from a validator (a version counter or
+   * a hash of the content) and answers `304 Not Modified` if the client already has it.
+   * @return true if the response is complete; the lambda then returns without sending a body.
+   */
+  bool check_etag(uint32_t validator);
+  bool check_etag(const std::string &etag);  // Opaque tag without quotes
+  /**
+   * Query parameters, parsed and percent-decoded on first use.
+   * The views stay valid while the request is handled; get_query_param() returns a copy.
+   */
   std::string get_query_param(const std::string &key);
+  std::string_view get_param(std::string_view key) { return this->query_params().get(key); }
+  bool has_param(std::string_view key) { return this->query_params().has(key); }
+  int32_t get_int_param(std::string_view key, int32_t fallback = 0) {
+    return this->query_params().get_int(key, fallback);
+  }
+  float get_float_param(std::string_view key, float fallback = 0.0f) {
+    return this->query_params().get_float(key, fallback);
+  }
+  bool get_bool_param(std::string_view key, bool fallback = false) {
+    return this->query_params().get_bool(key, fallback);
+  }
+  const QueryParams &query_params();
   std::string get_key_value();
-  void set_unique_header_fields(const bool state) { this->use_unique_header_fields_ = state; }
+
+  /**
+   * Producer of a streamed response body: fills `buffer` with up to `size` bytes and returns
+   * the number of bytes written, STREAM_END when the body is complete or STREAM_PENDING if
+   * no data is ready yet (the producer is asked again a little later).
+   */
+  using stream_producer_t = std::function<int(char *buffer, size_t size)>;
+  /**
+   * Size of the coalescing buffer: one TCP segment minus the chunk framing
+   * ("5a0\r\n" before and "\r\n" after the data).
+   */
+#ifdef CONFIG_LWIP_TCP_MSS
+  static constexpr size_t OUTPUT_BUFFER_SIZE = CONFIG_LWIP_TCP_MSS - 7;
+#else
+  static constexpr size_t OUTPUT_BUFFER_SIZE = 1440 - 7;
+#endif
+
+  static constexpr int STREAM_END = 0;
+  static constexpr int STREAM_PENDING = -1;
+
+  /**
+   * Registers a producer that is pulled for the response body after the lambda returned.
+   * The httpd task sends one chunk per step and handles other connections in between,
+   * so long responses need neither a loop nor delays in the lambda.
+   */
+  void stream(stream_producer_t producer, size_t chunk_size = 1024);
+
+  /**
+   * Producer that can start anywhere: fills `buffer` with up to `size` bytes of the body from
+   * `offset` on. Return values as for stream_producer_t.
+   */
+  using seekable_producer_t = std::function<int(size_t offset, char *buffer, size_t size)>;
+
+  /**
+   * Streams a body of known size and answers `Range: bytes=` requests with
+   * `206 Partial Content`, so only the requested window is produced. Call it before anything
+   * is sent. If-Range is compared with the tag set by check_etag(), which therefore has to
+   * describe the body the producer reads, not content that may have changed since.
+   */
+  void stream_seekable(size_t total_size, seekable_producer_t producer, size_t chunk_size = 1024);
+
+  // False once the connection failed; further sends are skipped
+  bool is_active() const { return this->req_ != nullptr; }
+  httpd_req_t *get_request() const { return this->req_; }
+  const WebServerRoutes::RouteEntry &get_route() const { return *this->route_; }
 
  protected:
-  bool check_request_();
-  void reset_request_context_();
-  void handle_native_request_(httpd_req_t *req, RouteEntry &route);
-  std::optional<std::string> has_header_(const std::string &field) const;
+  friend class WebServerRoutes;
 
-  web_server_base::WebServerBase *base_;
-  httpd_req_t *current_req_{nullptr};
-  RouteEntry *current_route_{nullptr};
-  std::vector<std::unique_ptr<RouteEntry>> routes_;
-  bool is_busy_{false};
-  bool use_unique_header_fields_{true};
+  bool check_request_();
+  void close_();
+  bool ensure_buffer_();
+  esp_err_t flush_();
+  bool end_response_();
+  esp_err_t send_sized_(const char *data, size_t len);
+  bool negotiate_gzip_();
+  void finish_encoding_();
+  esp_err_t write_raw_(const char *data, size_t len);
+  void start_capture_(size_t limit);
+  void replay_(const ResponseCache::Entry &entry);
+  bool if_none_match_(std::string_view etag);
+  bool get_request_header_(const char *field, char *value, size_t size);
+  esp_err_t write_(const char *data, size_t len);
+  esp_err_t send_chunk_(const char *data, size_t len);
+  void run_stream_();
+  const char *find_header_(const char *field) const;
+  bool add_header_(const char *field, const char *value);
+
+  httpd_req_t *req_;
+  WebServerRoutes::RouteEntry *route_;
+  bool use_unique_header_fields_;
+  SendPacer pacer_;
+
+  std::string etag_;    // Quoted tag set by check_etag()
+  std::string status_;  // Status line set by set_status(); httpd keeps only the pointer
+
+  // Capture of the response for the cache (body before compression, headers set in the lambda)
+  bool capturing_{false};
+  size_t capture_limit_{0};
+  std::string capture_body_;
+  std::string capture_headers_;
+  std::string capture_etag_;
+  QueryParams query_;
+  bool query_parsed_{false};
+
+  std::unique_ptr<GzipEncoder> encoder_;  // Set if the response is sent gzip compressed
+  std::unique_ptr<char[]> out_buffer_;    // Coalesces small writes, allocated on first use
+  size_t out_len_{0};
+
+  bool chunked_{false};         // Headers are out, the body is sent in chunks
+  bool sized_{false};           // The rest of the body is sent in one piece with Content-Length
+  bool finished_{false};        // The client received the complete response
+  bool keep_alive_{false};      // The connection stays open afterwards
+  int64_t content_length_{-1};  // Body size announced by send_content_size(), -1 = unknown
 
   /**
-   * Stores HTTP headers with stable memory addresses.
-   * ESP-IDF stores only pointers; unique_ptr ensures strings remain at fixed
-   * locations even if the vector reallocates, preventing pointer invalidation.
+   * Headers registered for this request. ESP-IDF stores only pointers: static headers point
+   * to flash, headers set in the lambda to `header_strings_` (one "field\0value" block each,
+   * which keeps its address when the vector grows).
    */
-  std::vector<std::unique_ptr<std::string>> current_headers_;
+  static constexpr size_t MAX_HEADERS = 16;
+  std::array<StaticHeader, MAX_HEADERS> header_table_;
+  size_t header_count_{0};
+  std::vector<std::unique_ptr<char[]>> header_strings_;
+
+  stream_producer_t stream_producer_;
+  size_t stream_chunk_size_{0};
 };
 
 }  // namespace web_server_routes
@@ -2,6 +2,8 @@
 
 #include "esphome/components/display/display_buffer.h"
 #include <freertos/FreeRTOS.h>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include "esp_timer.h"
 #include "esphome.h"
@@ -114,11 +116,20 @@ class DisplayStream {
       ptr32[i] = ((val << 8) & 0xFF00FF00) | ((val >> 8) & 0x00FF00FF);
     }
 
+    // Published only now: streams in the web server task read the buffer as soon as this is set
+    snapshot_version_ = frame_version_.load();
+    snapshot_ready_ = true;
     return true;
   }
 
+  /**
+   * Push interface: call it in a loop until it returns false. It registers its own download on
+   * the first call and releases it after the last chunk, so start_streaming() is not needed.
+   */
   bool get_bmp_chunk(std::function<void(const char *, size_t)> send_callback) {
     if (!header_sent_) {
+      chunk_download_ = start_streaming();
+      current_pos_ = 0;
       auto header = get_bmp_header();
       send_callback(header, TOTAL_HEADER_SIZE);
       header_sent_ = true;
@@ -127,12 +138,12 @@ class DisplayStream {
 
     // Check if we have already sent everything
     if (current_pos_ >= buffer_length_) {
-      is_streaming_ = false;
+      finish_bmp_chunks_();
       return false;
     }
 
     // Snapshot ready?
-    if (snapshot_buffer_ == nullptr) {
+    if (!snapshot_ready_) {
       ESP_LOGI(TAG, "Waiting for snapshot ...");
       delay(100);
       return true;  // while loop keep going. waiting for snapshot
@@ -152,7 +163,111 @@ class DisplayStream {
     current_pos_ += actual_chunk_size;
 
     // Return true if there is still data left for the next iteration
-    return current_pos_ < buffer_length_;
+    if (current_pos_ < buffer_length_) {
+      return true;
+    }
+    finish_bmp_chunks_();
+    return false;
+  }
+
+  /**
+   * Pull interface for streamed responses (web_server_routes `it.stream()`):
+   * copies the next part of the BMP file (header, then pixel data) into `buffer`.
+   * The position is shared, so only one download at a time; use read_bmp_at() otherwise.
+   * @return Bytes written, 0 when the file is complete, -1 while the snapshot is not ready yet.
+   */
+  int read_bmp(char *buffer, size_t size) {
+    int len = read_bmp_at(read_pos_, buffer, size);
+    if (len > 0)
+      read_pos_ += len;
+    return len;
+  }
+
+  /**
+   * Seekable variant for `it.stream_seekable()`: copies the part of the BMP file that starts
+   * at `offset`, so range requests only read the requested window.
+   */
+  int read_bmp_at(size_t offset, char *buffer, size_t size) {
+    if (!snapshot_ready_) {
+      return -1;  // Waiting for snapshot
+    }
+
+    const size_t file_size = get_file_size();
+    if (offset >= file_size) {
+      return 0;
+    }
+
+    size_t written = 0;
+    if (offset < TOTAL_HEADER_SIZE) {
+      const char *header = get_bmp_header();
+      written = std::min(size, TOTAL_HEADER_SIZE - offset);
+      memcpy(buffer, header + offset, written);
+      offset += written;
+    }
+
+    // Fill the rest of the buffer with pixel data, so the header does not go out alone
+    const size_t count = std::min(size - written, file_size - offset);
+    memcpy(buffer + written, snapshot_buffer_ + (offset - TOTAL_HEADER_SIZE), count);
+
+    return written + count;
+  }
+
+  /**
+   * Version of the displayed frame. It changes when update_frame_version() finds different
+   * pixels or mark_changed() is called. The snapshot may still hold an older frame, so use
+   * get_snapshot_version() as validator for `it.check_etag()`.
+   */
+  uint32_t get_frame_version() const { return frame_version_; }
+
+  /**
+   * Version of the frame in the snapshot, i.e. of the pixels a download reads. Only valid
+   * once is_snapshot_ready() returns true.
+   */
+  uint32_t get_snapshot_version() const { return snapshot_version_; }
+
+  bool is_snapshot_ready() const { return snapshot_ready_; }
+
+  /**
+   * Blocks the calling task until the display lambda has taken the snapshot, polling every
+   * 10 ms. Call it in the route lambda after start_streaming(), so the ETag can be taken from
+   * the snapshot. @return false if no snapshot arrived within `timeout_ms`.
+   */
+  bool wait_for_snapshot(uint32_t timeout_ms = 2000) {
+    const uint32_t start = millis();
+    while (!snapshot_ready_) {
+      if (millis() - start >= timeout_ms) {
+        return false;
+      }
+      delay(10);
+    }
+    return true;
+  }
+
+  // Explicit change signal for scenes that know when they draw something new
+  void mark_changed() { frame_version_++; }
+
+  /**
+   * Hashes the display buffer (32 bits at a time, about 1 ms for 110 KB) and advances the
+   * frame version if the content differs from the last call. Call it at the end of the
+   * display lambda. @return true if the frame changed.
+   */
+  bool update_frame_version() {
+    if (buffer_ == nullptr)
+      return false;
+
+    const uint32_t *ptr32 = reinterpret_cast<const uint32_t *>(buffer_);
+    const size_t num_words = buffer_length_ / 4;
+    uint32_t hash = 2166136261u;  // FNV-1a offset basis, applied per word
+    for (size_t i = 0; i < num_words; i++) {
+      hash = (hash ^ ptr32[i]) * 16777619u;
+    }
+
+    if (hash == frame_hash_)
+      return false;
+
+    frame_hash_ = hash;
+    frame_version_++;
+    return true;
   }
 
   size_t get_file_size() {
@@ -160,15 +275,26 @@ class DisplayStream {
     return TOTAL_HEADER_SIZE + pixelDataSize;
   }
 
-  bool is_streaming() { return is_streaming_; }
+  bool is_streaming() { return active_streams_ > 0; }
   bool needs_snapshot() {  //
-    return is_streaming_ && (snapshot_buffer_ == nullptr);
+    return active_streams_ > 0 && !snapshot_ready_;
   }
 
-  void start_streaming() {
-    is_streaming_ = true;
-    header_sent_ = false;
-    current_pos_ = 0;
+  /**
+   * Registers a download. The first of several simultaneous downloads requests a fresh snapshot
+   * if the frame changed since the last one; the following ones share it, because the snapshot
+   * must not change while a stream reads it. Keep the returned handle in the producer: the
+   * download ends when it is destroyed, which also happens when the client disconnects.
+   */
+  [[nodiscard]] std::shared_ptr<void> start_streaming() {
+    if (active_streams_++ == 0) {
+      read_pos_ = 0;
+      // Re-armed only while no stream reads the snapshot
+      if (snapshot_version_ != frame_version_) {
+        snapshot_ready_ = false;
+      }
+    }
+    return std::shared_ptr<void>(nullptr, [this](void *) { active_streams_--; });
   }
 
  private:
@@ -180,10 +306,21 @@ class DisplayStream {
   size_t buffer_length_{0};                   // Buffer length
   size_t max_chunk_size_;                     // Max chunk size for sending
   size_t current_pos_{0};                     // Current position in buffer
+  size_t read_pos_{0};                        // Current position in the BMP file (read_bmp)
   bool header_sent_ = false;                  // Indicates weather header was sent
   int width_;
   int height_;
-  bool is_streaming_{false};
+  std::atomic<uint8_t> active_streams_{0};     // Downloads reading the snapshot
+  std::atomic<bool> snapshot_ready_{false};    // Snapshot taken for the current downloads
+  std::atomic<uint32_t> frame_version_{1};     // Version of the last drawn frame
+  std::atomic<uint32_t> snapshot_version_{0};  // Version of the frame in the snapshot
+  uint32_t frame_hash_{0};
+  std::shared_ptr<void> chunk_download_;  // Registration held by get_bmp_chunk()
+
+  void finish_bmp_chunks_() {
+    header_sent_ = false;
+    chunk_download_.reset();
+  }
 
   // Helper funktion to create the BMP image header
   const char *get_bmp_header() {
@@ -0,0 +1,94 @@
+/**
+ * Benchmark for GfxBlendT::render_parallel() on the host (bands rendered by std::thread).
+ *
+ * Renders the same scene on a 172x320 canvas sequentially and with 2 - MAX_RENDER_WORKERS bands,
+ * checks that every variant produces the same framebuffer and prints the time per frame. The
+ * speedup depends on the cores of the machine running it. Part of it does not come from the
+ * threads: band canvases write raw into the framebuffer, while the sequential canvas goes through
+ * draw_pixel_at() for unblended shapes. On a single core that part is the whole difference. On
+ * single-core chips like the ESP32-C6 render_parallel() does not split the scene at all.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "fake_display.h"
+
+#include "esphome/components/gfx_blend/gfx_blend.h"
+#include "test_util.h"
+
+using namespace esphome;
+using namespace esphome::gfx_blend;
+
+namespace {
+
+constexpr int WIDTH = 172;
+constexpr int HEIGHT = 320;
+constexpr int FRAMES = 20;
+
+// Pure scene: the same drawing on every call, no state outside the canvas is modified. No blur,
+// which only sees its own band and therefore differs from sequential rendering at band edges.
+template<typename G> void scene(G &g) {
+  g.filled_rectangle(0, 0, WIDTH, HEIGHT, Color(20, 20, 20));
+  g.with(GfxEffects::alpha(100), [&]() {
+    g.filled_rectangle(5, 5, 150, 250, 12, Color(200, 30, 90));
+    g.filled_circle(80, 120, 60, Color(0, 0, 255));
+  });
+  g.with(GfxEffects::multiply, [&]() { g.filled_rectangle(10, 10, 150, 280, 8, Color(255, 200, 100)); });
+  g.drop_shadow(20, 200, 100, 60, 8, Shadow{4});
+}
+
+double frame_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+}
+
+void run(int rotation) {
+  FakeDisplay reference(WIDTH, HEIGHT, rotation);
+  reference.fill_pattern();
+  Gfx sequential(&reference);
+  scene(sequential);  // Warm-up: fills the shadow cache
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FRAMES; i++)
+    scene(sequential);
+  const double base = frame_ms(start);
+  std::printf("rotation %3d  sequential    %7.2f ms/frame\n", rotation, base);
+
+  for (uint8_t workers = 2; workers <= MAX_RENDER_WORKERS; workers++) {
+    FakeDisplay display(WIDTH, HEIGHT, rotation);
+    display.fill_pattern();
+    Gfx gfx(&display);
+    int calls = 0;
+    gfx.render_parallel(workers, [](auto &g) { scene(g); });
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FRAMES; i++) {
+      gfx.render_parallel(workers, [&](auto &g) {
+        scene(g);
+        // Only for the check below; a real scene must not write shared state
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        calls++;
+      });
+    }
+    const double ms = frame_ms(start);
+    std::printf("rotation %3d  %u bands       %7.2f ms/frame  speedup %.2fx\n", rotation, workers, ms, base / ms);
+
+    CHECK(display.pixels() == reference.pixels(), "rotation %d, %u bands differ from sequential rendering", rotation,
+          workers);
+    // The scene runs once per band
+    CHECK(calls == FRAMES * workers, "rotation %d: %d scene calls for %u bands", rotation, calls, workers);
+  }
+}
+
+}  // namespace
+
+int main() {
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  run(0);
+  run(90);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,93 @@
+/**
+ * In-memory RGB565 big-endian display for the gfx_blend host tests.
+ *
+ * draw_pixel_at() applies the rotation like the ESPHome display drivers, so raw framebuffer writes
+ * and pixel writes end up in the same place.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "esphome/components/display/display_buffer.h"
+#include "esphome/components/display/display_color_utils.h"
+
+namespace esphome {
+
+inline uint32_t millis() { return 0; }
+inline uint32_t micros() { return 0; }
+inline void delay(uint32_t ms) {}
+
+}  // namespace esphome
+
+class FakeDisplay : public esphome::display::DisplayBuffer {
+ public:
+  FakeDisplay(int w, int h, int rotation = 0) : w_(w), h_(h), pixels_(size_t(w) * h * 2) {
+    this->buffer_ = this->pixels_.data();
+    this->rotation_ = esphome::display::DisplayRotation(rotation);
+  }
+
+  int get_width() override { return this->swapped_() ? this->h_ : this->w_; }
+  int get_height() override { return this->swapped_() ? this->w_ : this->h_; }
+
+  void draw_pixel_at(int x, int y, esphome::Color color) override {
+    if (x < 0 || y < 0 || x >= this->get_width() || y >= this->get_height())
+      return;
+    this->pixel_writes++;
+    const size_t pos = this->native_pos_(x, y);
+    const uint16_t v = esphome::display::ColorUtil::color_to_565(color);
+    this->pixels_[pos] = uint8_t(v >> 8);
+    this->pixels_[pos + 1] = uint8_t(v);
+  }
+
+  // Logical pixel as RGB565
+  uint16_t get(int x, int y) const {
+    const size_t pos = this->native_pos_(x, y);
+    return uint16_t(this->pixels_[pos] << 8 | this->pixels_[pos + 1]);
+  }
+
+  // Deterministic pattern in every pixel
+  void fill_pattern() {
+    for (size_t i = 0; i < this->pixels_.size(); i++)
+      this->pixels_[i] = uint8_t((i * 2654435761u) >> 13);
+  }
+
+  const std::vector<uint8_t> &pixels() const { return this->pixels_; }
+
+  esphome::display::DisplayType get_display_type() override { return esphome::display::DISPLAY_TYPE_COLOR; }
+
+  int pixel_writes{0};
+
+ protected:
+  void draw_absolute_pixel_internal(int x, int y, esphome::Color color) override {}
+  int get_width_internal() override { return this->w_; }
+  int get_height_internal() override { return this->h_; }
+
+  bool swapped_() const { return this->rotation_ == 90 || this->rotation_ == 270; }
+
+  size_t native_pos_(int x, int y) const {
+    switch (this->rotation_) {
+      case esphome::display::DISPLAY_ROTATION_90_DEGREES:
+        std::swap(x, y);
+        x = this->w_ - x - 1;
+        break;
+      case esphome::display::DISPLAY_ROTATION_180_DEGREES:
+        x = this->w_ - x - 1;
+        y = this->h_ - y - 1;
+        break;
+      case esphome::display::DISPLAY_ROTATION_270_DEGREES:
+        std::swap(x, y);
+        y = this->h_ - y - 1;
+        break;
+      default:
+        break;
+    }
+    return (size_t(y) * this->w_ + x) * 2;
+  }
+
+  int w_;
+  int h_;
+  std::vector<uint8_t> pixels_;
+};
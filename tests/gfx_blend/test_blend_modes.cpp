@@ -0,0 +1,170 @@
+/**
+ * Host tests for the separable blend modes (blend_modes.h).
+ *
+ * Every mode is compared against the W3C Compositing Level 1 formulas evaluated in floating point:
+ * each channel may differ by at most 1 LSB from the rounded reference. The span and SWAR pair paths
+ * must produce exactly the same pixels as the scalar path.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "esphome/components/gfx_blend/blend_modes.h"
+#include "test_util.h"
+
+using namespace esphome::gfx_blend;
+
+namespace {
+
+// W3C reference formulas on normalized channels, s = source, b = backdrop
+double ref_multiply(double s, double b) { return s * b; }
+double ref_screen(double s, double b) { return s + b - s * b; }
+double ref_hard_light(double s, double b) { return s <= 0.5 ? 2 * s * b : 1 - 2 * (1 - s) * (1 - b); }
+double ref_overlay(double s, double b) { return ref_hard_light(b, s); }
+double ref_darken(double s, double b) { return std::min(s, b); }
+double ref_lighten(double s, double b) { return std::max(s, b); }
+double ref_difference(double s, double b) { return std::fabs(s - b); }
+
+double ref_soft_light(double s, double b) {
+  if (s <= 0.5)
+    return b - (1 - 2 * s) * b * (1 - b);
+  double d = b <= 0.25 ? ((16 * b - 12) * b + 4) * b : std::sqrt(b);
+  return b + (2 * s - 1) * (d - b);
+}
+
+double ref_color_dodge(double s, double b) {
+  if (b == 0)
+    return 0;
+  if (s >= 1)
+    return 1;
+  return std::min(1.0, b / (1 - s));
+}
+
+double ref_color_burn(double s, double b) {
+  if (b >= 1)
+    return 1;
+  if (s == 0)
+    return 0;
+  return 1 - std::min(1.0, (1 - b) / s);
+}
+
+template<uint32_t M> int quantize(double v) { return int(std::lround(std::clamp(v, 0.0, 1.0) * M)); }
+
+// Exhaustive per-channel check for one precision
+template<typename Op, uint32_t M> void check_channel(const char *name, double (*ref)(double, double)) {
+  for (uint32_t s = 0; s <= M; s++) {
+    for (uint32_t b = 0; b <= M; b++) {
+      int got = int(Op::template channel<M>(s, b));
+      int want = quantize<M>(ref(double(s) / M, double(b) / M));
+      CHECK(std::abs(got - want) <= 1, "%s M=%u s=%u b=%u: got %d, want %d", name, M, s, b, got, want);
+    }
+  }
+}
+
+// Sampled RGB565 pairs through the pixel, pair and span paths
+template<typename Op> void check_pixels(const char *name, double (*ref)(double, double)) {
+  using Mode = BlendMode<Op>;
+  test_util::Rng rng;
+  constexpr int N = 257;  // Odd, so the span ends with a single pixel
+  uint16_t fg[N], bg[N], out[N];
+
+  for (int round = 0; round < 64; round++) {
+    for (int i = 0; i < N; i++) {
+      fg[i] = uint16_t(rng.next());
+      bg[i] = uint16_t(rng.next());
+      out[i] = fg[i];
+    }
+    // Full-range and zero channels, where saturating paths switch
+    fg[0] = 0x0000;
+    fg[1] = 0xFFFF;
+    bg[2] = 0x0000;
+    bg[3] = 0xFFFF;
+    out[0] = fg[0];
+    out[1] = fg[1];
+
+    Mode{}.span(0, 0, out, bg, N);
+
+    for (int i = 0; i < N; i++) {
+      uint16_t px = Mode::pixel(fg[i], bg[i]);
+      CHECK(out[i] == px, "%s span[%d] fg=%04x bg=%04x: %04x != pixel %04x", name, i, fg[i], bg[i], out[i], px);
+
+      const int shift[3] = {11, 5, 0};
+      const uint32_t max[3] = {31, 63, 31};
+      for (int c = 0; c < 3; c++) {
+        uint32_t s = (fg[i] >> shift[c]) & max[c];
+        uint32_t b = (bg[i] >> shift[c]) & max[c];
+        int got = (px >> shift[c]) & max[c];
+        int want = int(std::lround(std::clamp(ref(double(s) / max[c], double(b) / max[c]), 0.0, 1.0) * max[c]));
+        CHECK(std::abs(got - want) <= 1, "%s channel %d fg=%04x bg=%04x: got %d, want %d", name, c, fg[i], bg[i],
+              got, want);
+      }
+    }
+
+    // The packed pair must match two scalar pixels, in both halves
+    for (int i = 0; i + 1 < N; i += 2) {
+      uint32_t res = Mode::pair(fg[i] | (uint32_t(fg[i + 1]) << 16), bg[i] | (uint32_t(bg[i + 1]) << 16));
+      CHECK(uint16_t(res) == Mode::pixel(fg[i], bg[i]), "%s pair low fg=%04x bg=%04x", name, fg[i], bg[i]);
+      CHECK(uint16_t(res >> 16) == Mode::pixel(fg[i + 1], bg[i + 1]), "%s pair high fg=%04x bg=%04x", name,
+            fg[i + 1], bg[i + 1]);
+    }
+  }
+}
+
+template<typename Op> void check_mode(const char *name, double (*ref)(double, double)) {
+  check_channel<Op, 31>(name, ref);
+  check_channel<Op, 63>(name, ref);
+  check_pixels<Op>(name, ref);
+}
+
+// The SWAR helpers against their scalar definitions on every 5 and 6 bit field pair
+void check_packed() {
+  using blend_ops::Darken;
+  using blend_ops::Difference;
+  using blend_ops::Lighten;
+  for (uint32_t a = 0; a < 64; a++) {
+    for (uint32_t b = 0; b < 64; b++) {
+      uint32_t a5 = a & 31, b5 = b & 31;
+      // Same value in every field of both pixels: R5 G6 B5 | R5 G6 B5
+      auto pack = [](uint32_t v5, uint32_t v6) {
+        uint32_t px = (v5 << 11) | (v6 << 5) | v5;
+        return px | (px << 16);
+      };
+      uint32_t s = pack(a5, a), d = pack(b5, b);
+      CHECK(Darken::pair(s, d) == pack(std::min(a5, b5), std::min(a, b)), "darken pair %u %u", a, b);
+      CHECK(Lighten::pair(s, d) == pack(std::max(a5, b5), std::max(a, b)), "lighten pair %u %u", a, b);
+      CHECK(Difference::pair(s, d) == pack(a5 > b5 ? a5 - b5 : b5 - a5, a > b ? a - b : b - a),
+            "difference pair %u %u", a, b);
+    }
+  }
+}
+
+void check_tables() {
+  for (uint32_t i = 1; i < 64; i++) {
+    uint32_t want = uint32_t(std::lround(65536.0 / i));
+    CHECK(blend_ops::RECIP.v[i] == want, "RECIP[%u] = %u, want %u", i, blend_ops::RECIP.v[i], want);
+  }
+  for (uint32_t i = 0; i < 64; i++) {
+    uint32_t want = uint32_t(std::lround(std::sqrt(i / 63.0) * 63));
+    CHECK(blend_ops::SQRT63.v[i] == want, "SQRT63[%u] = %u, want %u", i, blend_ops::SQRT63.v[i], want);
+  }
+}
+
+}  // namespace
+
+int main() {
+  check_tables();
+  check_packed();
+
+  check_mode<blend_ops::Multiply>("multiply", ref_multiply);
+  check_mode<blend_ops::Screen>("screen", ref_screen);
+  check_mode<blend_ops::Overlay>("overlay", ref_overlay);
+  check_mode<blend_ops::Darken>("darken", ref_darken);
+  check_mode<blend_ops::Lighten>("lighten", ref_lighten);
+  check_mode<blend_ops::Difference>("difference", ref_difference);
+  check_mode<blend_ops::SoftLight>("soft_light", ref_soft_light);
+  check_mode<blend_ops::ColorDodge>("color_dodge", ref_color_dodge);
+  check_mode<blend_ops::ColorBurn>("color_burn", ref_color_burn);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,85 @@
+/**
+ * Host tests for the clip stack of GfxBlendT (push_clip / pop_clip).
+ */
+
+#include "fake_display.h"
+
+#include "esphome/components/gfx_blend/gfx_blend.h"
+#include "test_util.h"
+
+using namespace esphome;
+using namespace esphome::gfx_blend;
+
+namespace {
+
+bool same(const ClipRect &a, const ClipRect &b) { return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h; }
+
+// Nested clips intersect, and drawing only changes pixels inside the innermost one
+void check_nested(int rotation) {
+  FakeDisplay clipped(40, 30, rotation), reference(40, 30, rotation);
+  clipped.fill_pattern();
+  reference.fill_pattern();
+  const FakeDisplay original = clipped;
+
+  Gfx gfx(&clipped), ref(&reference);
+  CHECK(gfx.push_clip(-4, 3, 20, 100), "push_clip");
+  CHECK(gfx.push_clip(5, 6, 30, 12), "nested push_clip");
+  const ClipRect clip = gfx.get_clip();
+  CHECK(same(clip, ClipRect{5, 6, 11, 12}), "intersection %d,%d %dx%d", clip.x, clip.y, clip.w, clip.h);
+
+  auto scene = [](Gfx &g) {
+    g.with(GfxEffects::alpha(100), [&]() { g.filled_rectangle(-10, -5, 80, 60, 7, Color(0, 255, 0)); });
+    g.filled_rectangle(0, 0, 20, 20, Color(255, 0, 0));
+  };
+  scene(gfx);
+  scene(ref);
+  gfx.pop_clip();
+  gfx.pop_clip();
+  CHECK(!gfx.has_clip(), "clip left after balanced pops");
+
+  for (int y = 0; y < clipped.get_height(); y++) {
+    for (int x = 0; x < clipped.get_width(); x++) {
+      const uint16_t want = clip.contains(x, y) ? reference.get(x, y) : original.get(x, y);
+      CHECK(clipped.get(x, y) == want, "rotation %d pixel %d,%d", rotation, x, y);
+    }
+  }
+}
+
+// Pushes beyond the stack depth are rejected; their pops must not remove an outer clip
+void check_overflow() {
+  FakeDisplay display(40, 30);
+  Gfx gfx(&display);
+
+  CHECK(gfx.push_clip(1, 1, 30, 20), "outer push_clip");
+  const ClipRect outer = gfx.get_clip();
+  for (int i = 1; i < CLIP_STACK_DEPTH; i++)
+    CHECK(gfx.push_clip(i, i, 30, 20), "push_clip level %d", i + 1);
+  const ClipRect innermost = gfx.get_clip();
+
+  CHECK(!gfx.push_clip(0, 0, 5, 5), "push_clip on a full stack");
+  CHECK(!gfx.push_clip(0, 0, 5, 5), "second push_clip on a full stack");
+  CHECK(same(gfx.get_clip(), innermost), "rejected push changed the clip");
+
+  gfx.pop_clip();
+  gfx.pop_clip();
+  CHECK(same(gfx.get_clip(), innermost), "pop of a rejected push removed a clip");
+
+  for (int i = 1; i < CLIP_STACK_DEPTH; i++)
+    gfx.pop_clip();
+  CHECK(gfx.has_clip() && same(gfx.get_clip(), outer), "outer clip lost after balanced pops");
+
+  gfx.pop_clip();
+  CHECK(!gfx.has_clip(), "clip left after the last pop");
+  gfx.pop_clip();  // Unbalanced pop is ignored
+  CHECK(!gfx.has_clip(), "unbalanced pop");
+}
+
+}  // namespace
+
+int main() {
+  for (int rotation : {0, 90, 180, 270})
+    check_nested(rotation);
+  check_overflow();
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,274 @@
+/**
+ * Host tests for Porter-Duff compositing and offscreen layers (compositing.h).
+ *
+ * The operators are compared against Result = Fs * S + Fd * D evaluated in floating point on
+ * premultiplied colors; colors and alphas may differ by at most 1 LSB. Layers are checked in both
+ * formats, including the premultiply/unpremultiply round trip and the alpha = 0 / 255 edges.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "esphome/components/gfx_blend/compositing.h"
+#include "test_util.h"
+
+using namespace esphome;
+using namespace esphome::gfx_blend;
+
+namespace {
+
+constexpr PorterDuff ALL_OPS[] = {
+    PorterDuff::CLEAR,   PorterDuff::SRC,     PorterDuff::DST,     PorterDuff::SRC_OVER,
+    PorterDuff::DST_OVER, PorterDuff::SRC_IN,  PorterDuff::DST_IN,  PorterDuff::SRC_OUT,
+    PorterDuff::DST_OUT, PorterDuff::SRC_ATOP, PorterDuff::DST_ATOP, PorterDuff::XOR,
+};
+
+const char *op_name(PorterDuff op) {
+  static const char *const NAMES[] = {"clear",   "src",    "dst",     "src_over", "dst_over", "src_in",
+                                      "dst_in",  "src_out", "dst_out", "src_atop", "dst_atop", "xor"};
+  return NAMES[int(op)];
+}
+
+// Porter-Duff factors on normalized alphas
+void ref_factors(PorterDuff op, double as, double ad, double &fs, double &fd) {
+  switch (op) {
+    case PorterDuff::CLEAR: fs = 0; fd = 0; break;
+    case PorterDuff::SRC: fs = 1; fd = 0; break;
+    case PorterDuff::DST: fs = 0; fd = 1; break;
+    case PorterDuff::SRC_OVER: fs = 1; fd = 1 - as; break;
+    case PorterDuff::DST_OVER: fs = 1 - ad; fd = 1; break;
+    case PorterDuff::SRC_IN: fs = ad; fd = 0; break;
+    case PorterDuff::DST_IN: fs = 0; fd = as; break;
+    case PorterDuff::SRC_OUT: fs = 1 - ad; fd = 0; break;
+    case PorterDuff::DST_OUT: fs = 0; fd = 1 - as; break;
+    case PorterDuff::SRC_ATOP: fs = ad; fd = 1 - as; break;
+    case PorterDuff::DST_ATOP: fs = 1 - ad; fd = as; break;
+    case PorterDuff::XOR: fs = 1 - ad; fd = 1 - as; break;
+  }
+}
+
+struct Pixel {
+  uint16_t c;
+  uint8_t a;
+};
+
+const int SHIFT[3] = {11, 5, 0};
+const int MAX[3] = {31, 63, 31};
+
+int channel(uint16_t c, int i) { return (c >> SHIFT[i]) & MAX[i]; }
+
+// A valid premultiplied pixel: no channel exceeds the alpha
+Pixel random_premultiplied(test_util::Rng &rng) {
+  const uint32_t bits = rng.next();
+  uint8_t a = uint8_t(bits);
+  if ((bits >> 8) % 4 == 0)
+    a = (bits >> 10) & 1 ? 255 : 0;  // Fully opaque and fully transparent edges
+  return {porter_duff::premultiply(uint16_t(bits >> 16), a), a};
+}
+
+Pixel ref_composite(PorterDuff op, Pixel s, Pixel d) {
+  double fs = 0, fd = 0;
+  ref_factors(op, s.a / 255.0, d.a / 255.0, fs, fd);
+  uint16_t c = 0;
+  for (int i = 0; i < 3; i++) {
+    double v = fs * channel(s.c, i) + fd * channel(d.c, i);
+    c |= uint16_t(std::min<long>(std::lround(v), MAX[i]) << SHIFT[i]);
+  }
+  return {c, uint8_t(std::min<long>(std::lround(fs * s.a + fd * d.a), 255))};
+}
+
+void check_pixel(const char *what, PorterDuff op, Pixel got, Pixel want, int tol_c, int tol_a) {
+  for (int i = 0; i < 3; i++) {
+    CHECK(std::abs(channel(got.c, i) - channel(want.c, i)) <= tol_c, "%s %s channel %d: got %04x, want %04x", what,
+          op_name(op), i, got.c, want.c);
+  }
+  CHECK(std::abs(got.a - want.a) <= tol_a, "%s %s alpha: got %d, want %d", what, op_name(op), got.a, want.a);
+}
+
+// All 12 operators on spans of random premultiplied pixels
+void check_operators() {
+  test_util::Rng rng;
+  constexpr int N = 200;
+  uint16_t sc[N], dc[N];
+  uint8_t sa[N], da[N];
+
+  for (PorterDuff op : ALL_OPS) {
+    for (int round = 0; round < 50; round++) {
+      Pixel src[N], dst[N];
+      for (int i = 0; i < N; i++) {
+        src[i] = random_premultiplied(rng);
+        dst[i] = random_premultiplied(rng);
+        sc[i] = src[i].c;
+        sa[i] = src[i].a;
+        dc[i] = dst[i].c;
+        da[i] = dst[i].a;
+      }
+      porter_duff::span(op, dc, da, sc, sa, N);
+      for (int i = 0; i < N; i++)
+        check_pixel("span", op, {dc[i], da[i]}, ref_composite(op, src[i], dst[i]), 1, 1);
+    }
+
+    // Every alpha combination with opaque white and black colors, including 0 and 255
+    for (uint32_t as = 0; as <= 255; as++) {
+      for (uint32_t ad = 0; ad <= 255; ad++) {
+        Pixel s{porter_duff::premultiply(0xFFFF, uint8_t(as)), uint8_t(as)};
+        Pixel d{porter_duff::premultiply(ad & 1 ? 0xFFFF : 0x0000, uint8_t(ad)), uint8_t(ad)};
+        uint16_t c = d.c;
+        uint8_t a = d.a;
+        porter_duff::span(op, &c, &a, &s.c, &s.a, 1);
+        check_pixel("alpha", op, {c, a}, ref_composite(op, s, d), 1, 1);
+      }
+    }
+  }
+}
+
+void check_premultiply() {
+  for (uint32_t alpha = 0; alpha <= 255; alpha++) {
+    for (uint32_t c = 0; c < 0x10000; c += 97) {
+      const uint16_t p = porter_duff::premultiply(uint16_t(c), uint8_t(alpha));
+      for (int i = 0; i < 3; i++) {
+        const long want = std::lround(channel(uint16_t(c), i) * alpha / 255.0);
+        CHECK(std::abs(channel(p, i) - want) <= 1, "premultiply %04x by %u channel %d", c, alpha, i);
+      }
+    }
+    // Edges: alpha 0 is black, alpha 255 the unchanged color
+    CHECK(porter_duff::premultiply(0xFFFF, 0) == 0, "premultiply alpha 0");
+    CHECK(porter_duff::premultiply(0xABCD, 255) == 0xABCD, "premultiply alpha 255");
+  }
+
+  for (uint32_t opacity = 0; opacity <= 255; opacity += 5) {
+    uint16_t c = 0xFFFF;
+    uint8_t a = 255;
+    porter_duff::scale_span(&c, &a, uint8_t(opacity), 1);
+    CHECK(c == porter_duff::premultiply(0xFFFF, uint8_t(opacity)) && a == opacity, "scale_span %u", opacity);
+  }
+}
+
+// Straight color -> premultiplied layer pixel -> straight color
+void check_round_trip(LayerFormat format) {
+  const bool argb4444 = format == LayerFormat::ARGB4444;
+  Layer layer(1, 1, format);
+  test_util::Rng rng;
+
+  for (int n = 0; n < 20000; n++) {
+    const uint32_t bits = rng.next();
+    const Color color(bits, bits >> 8, bits >> 16);
+    const uint8_t alpha = n < 256 ? uint8_t(n) : uint8_t(bits >> 24);
+    layer.draw_pixel(0, 0, color, alpha);
+
+    uint16_t c;
+    uint8_t a;
+    layer.load_span(0, 0, &c, &a, 1);
+
+    // Alpha: exact in RGB565_A8, nearest 4-bit step in ARGB4444
+    const int want_a = argb4444 ? (alpha + 8) / 17 * 17 : alpha;
+    CHECK(a == want_a, "%s alpha %u stored as %u", argb4444 ? "argb4444" : "rgb565_a8", alpha, a);
+
+    if (a == 0) {
+      CHECK(c == 0, "transparent pixel keeps color %04x", c);
+      continue;
+    }
+
+    const uint16_t c565 = display::ColorUtil::color_to_565(color);
+    for (int i = 0; i < 3; i++) {
+      const double straight = channel(c565, i) / double(MAX[i]);
+      const double premultiplied = channel(c, i) / double(MAX[i]);
+      // Premultiplied colors never exceed their alpha (up to one LSB of rounding)
+      CHECK(premultiplied <= a / 255.0 + 1.0 / MAX[i], "channel %d of %04x exceeds alpha %u", i, c, a);
+
+      // Unpremultiply: the error grows as 1 / alpha, one quantization step of the stored channel
+      const double step = argb4444 ? 1.0 / 15 : 1.0 / MAX[i];
+      const double tol = argb4444 ? 1.5 * step * 255.0 / a + 0.5 * 17.0 / a : step * 255.0 / a;
+      const double unpremultiplied = std::min(1.0, premultiplied * 255.0 / a);
+      CHECK(std::fabs(unpremultiplied - straight) <= tol + 1e-9, "round trip alpha %u channel %d: %.3f vs %.3f",
+            alpha, i, unpremultiplied, straight);
+      if (alpha == 255 && !argb4444)
+        CHECK(c == c565, "opaque pixel %04x != %04x", c, c565);
+    }
+  }
+}
+
+// fill() with every operator, compared with the operator applied to the stored destination
+void check_layer_fill(LayerFormat format) {
+  const bool argb4444 = format == LayerFormat::ARGB4444;
+  const char *name = argb4444 ? "argb4444 fill" : "rgb565_a8 fill";
+  // ARGB4444 rounds the result to 4 bit: half a step (63 / 30 and 17 / 2) plus 1 LSB
+  const int tol_c = argb4444 ? 3 : 1;
+  const int tol_a = argb4444 ? 9 : 1;
+  test_util::Rng rng;
+  constexpr int W = 70, H = 3;  // Wider than SPAN_CHUNK
+  Layer layer(W, H, format);
+
+  for (PorterDuff op : ALL_OPS) {
+    for (int round = 0; round < 40; round++) {
+      const uint32_t bits = rng.next();
+      layer.fill(0, 0, W, H, Color(bits, bits >> 8, bits >> 16), uint8_t(bits >> 24), PorterDuff::SRC);
+
+      Pixel before;
+      layer.load_span(W - 1, H - 1, &before.c, &before.a, 1);
+
+      const uint32_t src_bits = rng.next();
+      uint8_t alpha = uint8_t(src_bits >> 24);
+      if (round < 2)
+        alpha = round == 0 ? 0 : 255;
+      const Color color(src_bits, src_bits >> 8, src_bits >> 16);
+      layer.fill(0, 0, W, H, color, alpha, op);
+
+      const Pixel src{porter_duff::premultiply(display::ColorUtil::color_to_565(color), alpha), alpha};
+      const Pixel want = ref_composite(op, src, before);
+      for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+          Pixel got;
+          layer.load_span(x, y, &got.c, &got.a, 1);
+          check_pixel(name, op, got, want, tol_c, tol_a);
+        }
+      }
+    }
+  }
+
+  // Edges: SRC with alpha 0 erases, SRC_OVER with alpha 255 is opaque
+  layer.fill(0, 0, W, H, Color(200, 100, 50), 255, PorterDuff::SRC);
+  layer.fill(0, 0, W, H, Color(255, 255, 255), 0, PorterDuff::SRC);
+  Pixel p;
+  layer.load_span(0, 0, &p.c, &p.a, 1);
+  CHECK(p.c == 0 && p.a == 0, "%s: SRC with alpha 0 left %04x/%u", name, p.c, p.a);
+
+  layer.fill(0, 0, W, H, Color(255, 255, 255), 255, PorterDuff::SRC_OVER);
+  layer.load_span(0, 0, &p.c, &p.a, 1);
+  CHECK(p.c == 0xFFFF && p.a == 255, "%s: opaque SRC_OVER gave %04x/%u", name, p.c, p.a);
+
+  layer.fill(0, 0, W, H, Color(0, 0, 0), 0, PorterDuff::SRC_OVER);
+  layer.load_span(0, 0, &p.c, &p.a, 1);
+  CHECK(p.c == 0xFFFF && p.a == 255, "%s: transparent SRC_OVER changed %04x/%u", name, p.c, p.a);
+}
+
+// Layer onto layer, mixing both formats and an opacity
+void check_layer_composite() {
+  Layer top(10, 1, LayerFormat::ARGB4444);
+  Layer bottom(10, 1, LayerFormat::RGB565_A8);
+  top.fill(0, 0, 10, 1, Color(255, 0, 0), 255);
+  bottom.fill(0, 0, 10, 1, Color(0, 0, 255), 255);
+  bottom.composite(top, 5, 0, PorterDuff::SRC_OVER, 128);
+
+  Pixel p;
+  bottom.load_span(0, 0, &p.c, &p.a, 1);
+  CHECK(p.c == 0x001F && p.a == 255, "outside the composited area: %04x/%u", p.c, p.a);
+  bottom.load_span(9, 0, &p.c, &p.a, 1);
+  const Pixel want = ref_composite(PorterDuff::SRC_OVER, {porter_duff::premultiply(0xF800, 128), 128}, {0x001F, 255});
+  check_pixel("composite", PorterDuff::SRC_OVER, p, want, 1, 1);
+}
+
+}  // namespace
+
+int main() {
+  check_premultiply();
+  check_operators();
+  check_round_trip(LayerFormat::RGB565_A8);
+  check_round_trip(LayerFormat::ARGB4444);
+  check_layer_fill(LayerFormat::RGB565_A8);
+  check_layer_fill(LayerFormat::ARGB4444);
+  check_layer_composite();
+
+  return TEST_RESULT();
+}
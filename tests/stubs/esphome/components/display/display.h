@@ -0,0 +1,81 @@
+// Host stub: the parts of esphome::display::Display used by gfx_blend
+#pragma once
+
+#include "esphome/core/color.h"
+#include "esphome/core/component.h"
+#include "esphome/core/optional.h"
+
+#include <functional>
+
+namespace esphome {
+namespace display {
+
+enum DisplayType {
+  DISPLAY_TYPE_NONE = 0,
+  DISPLAY_TYPE_BINARY = 1,
+  DISPLAY_TYPE_GRAYSCALE = 2,
+  DISPLAY_TYPE_COLOR = 3,
+};
+
+enum DisplayRotation {
+  DISPLAY_ROTATION_0_DEGREES = 0,
+  DISPLAY_ROTATION_90_DEGREES = 90,
+  DISPLAY_ROTATION_180_DEGREES = 180,
+  DISPLAY_ROTATION_270_DEGREES = 270,
+};
+
+enum class TextAlign { TOP_LEFT = 0 };
+
+class BaseFont {};
+
+class Display;
+using display_writer_t = std::function<void(Display &)>;
+
+class Display : public PollingComponent {
+ public:
+  virtual void fill(Color color) {}
+  void clear() {}
+  virtual int get_width() { return 0; }
+  virtual int get_height() { return 0; }
+  virtual void draw_pixel_at(int x, int y, Color color) = 0;
+
+  void horizontal_line(int x, int y, int width, Color color = Color()) {
+    for (int i = 0; i < width; i++)
+      this->draw_pixel_at(x + i, y, color);
+  }
+  void vertical_line(int x, int y, int height, Color color = Color()) {
+    for (int i = 0; i < height; i++)
+      this->draw_pixel_at(x, y + i, color);
+  }
+  void filled_rectangle(int x1, int y1, int width, int height, Color color = Color()) {
+    for (int j = 0; j < height; j++)
+      this->horizontal_line(x1, y1 + j, width, color);
+  }
+  void filled_circle(int x, int y, int r, Color color = Color()) {
+    for (int dy = -r; dy <= r; dy++)
+      for (int dx = -r; dx <= r; dx++)
+        if (dx * dx + dy * dy <= r * r)
+          this->draw_pixel_at(x + dx, y + dy, color);
+  }
+  void filled_ring(int x, int y, int r1, int r2, Color color = Color()) {}
+  void filled_triangle(int x1, int y1, int x2, int y2, int x3, int y3, Color color = Color()) {}
+  void print(int x, int y, BaseFont *font, Color color, TextAlign align, const char *text,
+             Color background = Color()) {}
+
+  virtual DisplayType get_display_type() = 0;
+  DisplayRotation get_rotation() const { return this->rotation_; }
+  void set_writer(display_writer_t &&writer) { this->writer_ = writer; }
+  void update() override {}
+
+ protected:
+  virtual int get_width_internal() = 0;
+  virtual int get_height_internal() = 0;
+  int get_native_width() { return this->get_width_internal(); }
+  int get_native_height() { return this->get_height_internal(); }
+
+  DisplayRotation rotation_{DISPLAY_ROTATION_0_DEGREES};
+  optional<display_writer_t> writer_{};
+};
+
+}  // namespace display
+}  // namespace esphome
@@ -0,0 +1,22 @@
+// Host stub: esphome::display::DisplayBuffer with a raw framebuffer pointer
+#pragma once
+
+#include "display.h"
+
+namespace esphome {
+namespace display {
+
+class DisplayBuffer : public Display {
+ public:
+  void draw_pixel_at(int x, int y, Color color) override { this->draw_absolute_pixel_internal(x, y, color); }
+  int get_width() override { return this->get_width_internal(); }
+  int get_height() override { return this->get_height_internal(); }
+
+ protected:
+  virtual void draw_absolute_pixel_internal(int x, int y, Color color) = 0;
+
+  uint8_t *buffer_{nullptr};
+};
+
+}  // namespace display
+}  // namespace esphome
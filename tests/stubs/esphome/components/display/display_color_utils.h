@@ -0,0 +1,19 @@
+// Host stub: RGB565 conversion from esphome/components/display/display_color_utils.h
+#pragma once
+
+#include "esphome/core/color.h"
+
+namespace esphome {
+namespace display {
+
+enum ColorOrder : uint8_t { COLOR_ORDER_RGB = 0, COLOR_ORDER_BGR = 1, COLOR_ORDER_GRB = 2 };
+
+class ColorUtil {
+ public:
+  static uint16_t color_to_565(Color color, ColorOrder order = ColorOrder::COLOR_ORDER_RGB) {
+    return ((color.r >> 3) << 11) | ((color.g >> 2) << 5) | (color.b >> 3);
+  }
+};
+
+}  // namespace display
+}  // namespace esphome
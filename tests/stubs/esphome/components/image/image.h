@@ -0,0 +1,20 @@
+// Host stub: image interface used by GfxEffects::image_mask
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace image {
+
+enum ImageType { IMAGE_TYPE_BINARY = 0, IMAGE_TYPE_GRAYSCALE = 1, IMAGE_TYPE_RGB = 2, IMAGE_TYPE_RGB565 = 3 };
+
+class Image {
+ public:
+  int get_width() const { return 0; }
+  int get_height() const { return 0; }
+  ImageType get_type() const { return IMAGE_TYPE_BINARY; }
+  const uint8_t *get_data_start() const { return nullptr; }
+};
+
+}  // namespace image
+}  // namespace esphome
@@ -0,0 +1,22 @@
+// Host stub: the parts of esphome/core/color.h used by the headers under test
+#pragma once
+
+#include <cstdint>
+
+#define HOT __attribute__((hot))
+
+namespace esphome {
+
+struct Color {
+  union {
+    struct {
+      uint8_t r, g, b, w;
+    };
+    uint8_t raw[4];
+    uint32_t raw_32;
+  };
+  constexpr Color() : r(0), g(0), b(0), w(0) {}
+  constexpr Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) : r(r), g(g), b(b), w(w) {}
+};
+
+}  // namespace esphome
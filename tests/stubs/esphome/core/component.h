@@ -0,0 +1,21 @@
+// Host stub: component base classes without scheduling
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+};
+
+class PollingComponent : public Component {
+ public:
+  virtual void update() = 0;
+};
+
+}  // namespace esphome
@@ -0,0 +1,2 @@
+// Host stub: no optional features enabled
+#pragma once
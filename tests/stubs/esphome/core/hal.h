@@ -0,0 +1,12 @@
+// Host stub: timing functions, defined by the tests that need them
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+}  // namespace esphome
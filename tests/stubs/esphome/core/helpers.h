@@ -0,0 +1,26 @@
+// Host stub: RAMAllocator on top of malloc, random_uint32()
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace esphome {
+
+// Defined by the tests that need it
+uint32_t random_uint32();
+
+template<class T> class RAMAllocator {
+ public:
+  enum : uint8_t { NONE = 0, ALLOC_EXTERNAL = 1, ALLOC_INTERNAL = 2, ALLOW_FAILURE = 4 };
+
+  RAMAllocator() = default;
+  RAMAllocator(uint8_t flags) {}
+
+  T *allocate(size_t n) { return static_cast<T *>(std::malloc(n * sizeof(T))); }
+  void deallocate(T *p, size_t n) { std::free(p); }
+};
+
+template<class T> using ExternalRAMAllocator = RAMAllocator<T>;
+
+}  // namespace esphome
@@ -0,0 +1,10 @@
+// Host stub: esphome::optional is std::optional
+#pragma once
+
+#include <optional>
+
+namespace esphome {
+
+template<class T> using optional = std::optional<T>;
+
+}  // namespace esphome
@@ -0,0 +1,42 @@
+/**
+ * Minimal assertion helpers for the host tests.
+ *
+ * Every test is a plain executable that returns the number of failed checks, so ctest needs no
+ * test framework.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+namespace test_util {
+
+inline int failures = 0;
+
+// Deterministic xorshift32, the same sequence on every run
+struct Rng {
+  uint32_t state{0x2545F491};
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+};
+
+}  // namespace test_util
+
+#define CHECK(cond, ...) \
+  do { \
+    if (!(cond)) { \
+      if (test_util::failures++ < 20) { \
+        std::printf("%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+        std::printf(__VA_ARGS__); \
+        std::printf("\n"); \
+      } \
+    } \
+  } while (0)
+
+#define TEST_RESULT() \
+  (test_util::failures == 0 ? (std::printf("OK\n"), 0) : (std::printf("%d failures\n", test_util::failures), 1))
@@ -0,0 +1,111 @@
+/**
+ * Benchmark for GzipEncoder (gzip_encoder.h) on the host.
+ *
+ * Compresses JSON, CSV and incompressible data with every window size and prints the bytes on
+ * the wire and the time per KB of input, with zlib (level 1 and 6) as reference for the size.
+ * The times are host times; only their ratios between window sizes and inputs carry over.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <zlib.h>
+
+#include "esphome/components/web_server_routes/gzip_encoder.h"
+#include "test_util.h"
+
+using esphome::web_server_routes::GzipEncoder;
+
+namespace {
+
+constexpr size_t INPUT_SIZE = 256 * 1024;
+constexpr size_t OUTPUT_SIZE = 1460;  // One TCP segment, as in the web server
+constexpr size_t WRITE_SIZE = 512;   // Typical size of one send() from a route lambda
+constexpr int RUNS = 5;
+
+test_util::Rng rng;
+
+std::string make_json() {
+  std::string text;
+  char row[96];
+  for (uint32_t i = 0; text.size() < INPUT_SIZE; i++) {
+    snprintf(row, sizeof(row), "{\"id\":%u,\"sensor\":\"temp_%u\",\"value\":%u.%u,\"ok\":true},\n", i, i % 7,
+             rng.next() % 40, rng.next() % 10);
+    text += row;
+  }
+  text.resize(INPUT_SIZE);
+  return text;
+}
+
+std::string make_csv() {
+  std::string text;
+  char row[64];
+  for (uint32_t i = 0; text.size() < INPUT_SIZE; i++) {
+    snprintf(row, sizeof(row), "%u;%u;%u;%u\n", 1700000000u + i * 60, 200 + rng.next() % 50, rng.next() % 1000,
+             rng.next() % 2);
+    text += row;
+  }
+  text.resize(INPUT_SIZE);
+  return text;
+}
+
+std::string make_random() {
+  std::string data(INPUT_SIZE, '\0');
+  for (auto &c : data)
+    c = char(rng.next() >> 24);
+  return data;
+}
+
+size_t zlib_size(const std::string &input, int level) {
+  z_stream zs{};
+  deflateInit2(&zs, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&zs, input.size()), '\0');
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+  zs.avail_in = input.size();
+  zs.next_out = reinterpret_cast<Bytef *>(out.data());
+  zs.avail_out = out.size();
+  deflate(&zs, Z_FINISH);
+  const size_t size = zs.total_out;
+  deflateEnd(&zs);
+  return size;
+}
+
+void run(const char *name, const std::string &input) {
+  std::printf("%-6s %zu bytes   zlib -1: %zu   zlib -6: %zu\n", name, input.size(), zlib_size(input, 1),
+              zlib_size(input, 6));
+
+  for (size_t window = GzipEncoder::MIN_WINDOW; window <= GzipEncoder::MAX_WINDOW; window *= 2) {
+    size_t wire = 0;
+    double best_us = 0;
+    for (int run = 0; run < RUNS; run++) {
+      GzipEncoder encoder(window, OUTPUT_SIZE);
+      wire = 0;
+      encoder.set_sink([&](const uint8_t *, size_t len) {
+        wire += len;
+        return true;
+      });
+      encoder.init();
+
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t pos = 0; pos < input.size(); pos += WRITE_SIZE) {
+        encoder.write(reinterpret_cast<const uint8_t *>(input.data() + pos), std::min(WRITE_SIZE, input.size() - pos));
+      }
+      encoder.finish();
+      const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      if (run == 0 || us < best_us)
+        best_us = us;
+    }
+    std::printf("  window %4zu   %7zu bytes on the wire (%5.1f %%)   %6.2f us/KB\n", window, wire,
+                100.0 * wire / input.size(), best_us / (input.size() / 1024.0));
+  }
+}
+
+}  // namespace
+
+int main() {
+  run("json", make_json());
+  run("csv", make_csv());
+  run("random", make_random());
+  return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * Host tests for ConnectionTable (connection_table.h): slot limits, LRU eviction of idle
+ * connections, expiry after the idle timeout, sockets that are gone and reused socket numbers.
+ */
+
+#include <set>
+#include <vector>
+
+#include "esphome/components/web_server_routes/connection_table.h"
+#include "test_util.h"
+
+using esphome::web_server_routes::ConnectionTable;
+
+namespace {
+
+// Socket state as getpeername() would see it: fd -> peer, missing = closed
+struct Sockets {
+  std::vector<uint32_t> peers = std::vector<uint32_t>(64, 0);
+  std::vector<int> closed;
+
+  void expire(ConnectionTable &table, uint32_t now) {
+    table.expire(
+        now, [this](int fd, uint32_t peer) { return this->peers[fd] == peer; },
+        [this](int fd) { this->closed.push_back(fd); });
+  }
+};
+
+void check_configure() {
+  ConnectionTable table;
+  CHECK(!table.is_enabled(), "enabled without an idle timeout");
+  table.configure(5000, 0);
+  CHECK(table.is_enabled() && table.get_idle_timeout() == 5000, "idle timeout not applied");
+
+  // A limit of 0 still keeps one connection, more than MAX_CONNECTIONS are capped
+  int evicted = 0;
+  CHECK(table.acquire(3, 1, 0, evicted) && !table.acquire(4, 2, 0, evicted), "limit 0 is not one slot");
+
+  ConnectionTable large;
+  large.configure(5000, 100);
+  for (int fd = 0; fd < int(ConnectionTable::MAX_CONNECTIONS); fd++)
+    CHECK(large.acquire(fd, fd + 1, 0, evicted), "slot %d refused", fd);
+  CHECK(!large.acquire(50, 99, 0, evicted), "more than MAX_CONNECTIONS slots");
+}
+
+// Busy connections are never evicted; without an idle one the new connection is refused
+void check_busy() {
+  ConnectionTable table;
+  table.configure(5000, 3);
+  int evicted = 0;
+  for (int fd = 10; fd < 13; fd++)
+    CHECK(table.acquire(fd, fd, 100, evicted) && evicted == -1, "fd %d: refused or evicted %d", fd, evicted);
+
+  CHECK(!table.acquire(13, 13, 200, evicted) && evicted == -1, "busy connection evicted: %d", evicted);
+  CHECK(table.size() == 3, "size %zu", table.size());
+
+  // The same connection asking again keeps its slot
+  CHECK(table.acquire(11, 11, 300, evicted) && evicted == -1, "keep-alive request refused");
+}
+
+// Without a free slot the least recently released idle connection gives way
+void check_lru_eviction() {
+  ConnectionTable table;
+  table.configure(60000, 4);
+  int evicted = 0;
+  for (int fd = 20; fd < 24; fd++)
+    table.acquire(fd, fd, 0, evicted);
+
+  // Released in the order 22, 20, 23; 21 stays busy
+  table.release(22, 100);
+  table.release(20, 200);
+  table.release(23, 300);
+
+  const int expected[] = {22, 20, 23};
+  int fd = 30;
+  for (int victim : expected) {
+    CHECK(table.acquire(fd, fd, 400, evicted) && evicted == victim, "fd %d evicted %d, expected %d", fd, evicted,
+          victim);
+    fd++;
+  }
+  CHECK(!table.acquire(fd, fd, 400, evicted) && evicted == -1, "only busy connections left, evicted %d", evicted);
+
+  // Times across the millis() wrap still order correctly
+  ConnectionTable wrap;
+  wrap.configure(60000, 2);
+  wrap.acquire(1, 1, 0, evicted);
+  wrap.acquire(2, 2, 0, evicted);
+  wrap.release(1, UINT32_MAX - 10);  // Older
+  wrap.release(2, 5);                // Newer, after the wrap
+  CHECK(wrap.acquire(3, 3, 10, evicted) && evicted == 1, "wrap: evicted %d instead of 1", evicted);
+}
+
+// Idle connections are closed after the timeout, busy ones are kept however long they take
+void check_expiry() {
+  ConnectionTable table;
+  table.configure(5000, 4);
+  Sockets sockets;
+  int evicted = 0;
+  for (int fd = 1; fd <= 3; fd++) {
+    sockets.peers[fd] = 100 + fd;
+    table.acquire(fd, 100 + fd, 0, evicted);
+  }
+  table.release(1, 1000);
+  table.release(2, 3000);
+
+  sockets.expire(table, 5999);
+  CHECK(sockets.closed.empty() && table.size() == 3, "closed %zu before the timeout", sockets.closed.size());
+
+  sockets.expire(table, 6000);
+  CHECK(sockets.closed == std::vector<int>{1} && table.size() == 2, "closed %zu at 6000 ms, size %zu",
+        sockets.closed.size(), table.size());
+
+  sockets.expire(table, 100000);
+  CHECK(sockets.closed == (std::vector<int>{1, 2}) && table.size() == 1, "busy connection expired, size %zu",
+        table.size());
+
+  // A connection that is used again starts its idle time over
+  table.release(3, 100000);
+  table.acquire(3, 103, 104000, evicted);
+  table.release(3, 104000);
+  sockets.expire(table, 106000);
+  CHECK(table.size() == 1, "reused connection expired early");
+  sockets.expire(table, 109000);
+  CHECK(table.size() == 0 && sockets.closed.back() == 3, "reused connection not expired");
+
+  // Disabled (timeout 0): expire() closes nothing while the connections are busy
+  ConnectionTable off;
+  off.acquire(7, 1, 0, evicted);
+  sockets.peers[7] = 1;
+  sockets.closed.clear();
+  sockets.expire(off, 100000);
+  CHECK(sockets.closed.empty(), "busy connection closed with the table disabled");
+}
+
+// A socket closed by the client frees its slot without being closed again
+void check_gone() {
+  ConnectionTable table;
+  table.configure(5000, 4);
+  Sockets sockets;
+  int evicted = 0;
+  sockets.peers[5] = 77;
+  table.acquire(5, 77, 0, evicted);
+  table.release(5, 0);
+
+  sockets.peers[5] = 0;  // getpeername() fails
+  sockets.expire(table, 10);
+  CHECK(table.size() == 0 && sockets.closed.empty(), "gone socket: size %zu, closed %zu", table.size(),
+        sockets.closed.size());
+
+  // A busy connection whose socket is gone is dropped as well
+  sockets.peers[6] = 78;
+  table.acquire(6, 78, 0, evicted);
+  sockets.peers[6] = 0;
+  sockets.expire(table, 10);
+  CHECK(table.size() == 0 && sockets.closed.empty(), "gone busy socket kept");
+}
+
+// lwIP hands out the number of a closed socket again: the new peer must not be closed as idle
+void check_fd_reuse() {
+  ConnectionTable table;
+  table.configure(5000, 4);
+  Sockets sockets;
+  int evicted = 0;
+
+  sockets.peers[8] = 1001;
+  table.acquire(8, 1001, 0, evicted);
+  table.release(8, 0);
+
+  // The client closed, a new client got socket 8 before expire() ran
+  sockets.peers[8] = 2002;
+  sockets.expire(table, 6000);
+  CHECK(sockets.closed.empty(), "socket of the new client was closed");
+  CHECK(table.size() == 0, "stale slot kept for the reused socket");
+
+  // The new client's request takes over a slot still registered under the old peer
+  sockets.peers[9] = 3003;
+  table.acquire(9, 3003, 7000, evicted);
+  table.release(9, 7000);
+  sockets.peers[9] = 4004;
+  CHECK(table.acquire(9, 4004, 8000, evicted) && evicted == -1 && table.size() == 1, "reused fd: evicted %d, size %zu",
+        evicted, table.size());
+  table.release(9, 8000);
+  sockets.expire(table, 9000);
+  CHECK(table.size() == 1 && sockets.closed.empty(), "slot of the new peer dropped");
+  sockets.expire(table, 13000);
+  CHECK(sockets.closed == std::vector<int>{9}, "new peer not expired after its own idle time");
+}
+
+// remove() frees the slot; unknown sockets are ignored
+void check_remove() {
+  ConnectionTable table;
+  table.configure(5000, 2);
+  int evicted = 0;
+  table.acquire(1, 1, 0, evicted);
+  table.acquire(2, 2, 0, evicted);
+  table.remove(42);
+  table.release(42, 0);
+  CHECK(table.size() == 2, "unknown socket changed the table");
+  table.remove(1);
+  CHECK(table.acquire(3, 3, 0, evicted) && evicted == -1, "removed slot not reused (evicted %d)", evicted);
+}
+
+// Random operations: the table never exceeds its limit and never evicts a busy connection
+void check_random() {
+  test_util::Rng rng;
+  for (uint8_t limit = 1; limit <= ConnectionTable::MAX_CONNECTIONS; limit++) {
+    ConnectionTable table;
+    table.configure(2000, limit);
+    Sockets sockets;
+    std::set<int> busy;
+    uint32_t now = 0;
+
+    for (int step = 0; step < 5000; step++) {
+      now += rng.next() % 100;
+      const int fd = 1 + rng.next() % 20;
+      switch (rng.next() % 4) {
+        case 0:
+        case 1: {
+          if (sockets.peers[fd] == 0)
+            sockets.peers[fd] = rng.next() | 1;
+          int evicted = 0;
+          if (table.acquire(fd, sockets.peers[fd], now, evicted)) {
+            CHECK(busy.count(evicted) == 0, "limit %u: busy fd %d evicted", limit, evicted);
+            busy.erase(evicted);
+            busy.insert(fd);
+          } else {
+            CHECK(busy.size() >= limit, "limit %u: refused with %zu busy", limit, busy.size());
+          }
+          break;
+        }
+        case 2:
+          table.release(fd, now);
+          busy.erase(fd);
+          break;
+        default:
+          if (rng.next() % 8 == 0) {
+            sockets.peers[fd] = 0;  // Client closed
+            busy.erase(fd);
+          }
+          sockets.expire(table, now);
+          break;
+      }
+      CHECK(table.size() <= limit, "limit %u: %zu slots used", limit, table.size());
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  check_configure();
+  check_busy();
+  check_lru_eviction();
+  check_expiry();
+  check_gone();
+  check_fd_reuse();
+  check_remove();
+  check_random();
+  return TEST_RESULT();
+}
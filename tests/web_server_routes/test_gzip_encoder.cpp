@@ -0,0 +1,205 @@
+/**
+ * Host tests for GzipEncoder (gzip_encoder.h): every stream is decoded again with zlib, for all
+ * window sizes, across slide_() of the window, with flush() in the middle of the stream and with
+ * incompressible input.
+ */
+
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "esphome/components/web_server_routes/gzip_encoder.h"
+#include "test_util.h"
+
+using esphome::web_server_routes::GzipEncoder;
+
+namespace {
+
+test_util::Rng rng;
+
+const size_t WINDOWS[] = {512, 1024, 2048, 4096, 8192};
+
+// JSON rows with repeating keys and changing numbers, like a sensor log
+std::string make_text(size_t size) {
+  std::string text;
+  char row[96];
+  for (uint32_t i = 0; text.size() < size; i++) {
+    snprintf(row, sizeof(row), "{\"id\":%u,\"sensor\":\"temp_%u\",\"value\":%u.%u,\"ok\":true},\n", i, i % 7,
+             rng.next() % 40, rng.next() % 10);
+    text += row;
+  }
+  text.resize(size);
+  return text;
+}
+
+std::string make_random(size_t size) {
+  std::string data(size, '\0');
+  for (auto &c : data)
+    c = char(rng.next() >> 24);
+  return data;
+}
+
+// Long runs: matches of MAX_MATCH bytes and distances up to the window size
+std::string make_runs(size_t size) {
+  std::string data;
+  while (data.size() < size) {
+    data.append(1 + rng.next() % 600, char('a' + rng.next() % 3));
+    if (rng.next() % 4 == 0 && data.size() > 100)
+      data += data.substr(data.size() - 100, 50);
+  }
+  data.resize(size);
+  return data;
+}
+
+struct Decoder {
+  z_stream zs{};
+  std::string out;
+
+  Decoder() { inflateInit2(&zs, 16 + MAX_WBITS); }
+  ~Decoder() { inflateEnd(&zs); }
+
+  // Feeds compressed bytes; returns the zlib status of the last call
+  int feed(const std::string &data) {
+    zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    zs.avail_in = data.size();
+    int res = Z_OK;
+    do {
+      uint8_t buffer[4096];
+      zs.next_out = buffer;
+      zs.avail_out = sizeof(buffer);
+      res = inflate(&zs, Z_SYNC_FLUSH);
+      out.append(reinterpret_cast<char *>(buffer), sizeof(buffer) - zs.avail_out);
+    } while (res == Z_OK && (zs.avail_in > 0 || zs.avail_out == 0));
+    return res;
+  }
+};
+
+/**
+ * Compresses `input` in random pieces and checks that zlib restores it. With `flushes`,
+ * flush() is called at random points and everything written so far has to be decodable
+ * from the bytes sent up to then.
+ */
+void round_trip(const char *name, const std::string &input, size_t window, size_t output_size, bool flushes) {
+  GzipEncoder encoder(window, output_size);
+  std::string wire;
+  encoder.set_sink([&](const uint8_t *data, size_t len) {
+    CHECK(len <= output_size, "%s: sink got %zu bytes from a %zu byte buffer", name, len, output_size);
+    wire.append(reinterpret_cast<const char *>(data), len);
+    return true;
+  });
+  CHECK(encoder.init(), "%s: init failed for window %zu", name, window);
+
+  Decoder decoder;
+  size_t fed = 0;
+  size_t pos = 0;
+  while (pos < input.size()) {
+    const size_t len = std::min<size_t>(1 + rng.next() % (3 * window), input.size() - pos);
+    CHECK(encoder.write(reinterpret_cast<const uint8_t *>(input.data() + pos), len), "%s: write failed", name);
+    pos += len;
+
+    if (flushes && rng.next() % 3 == 0) {
+      CHECK(encoder.flush(), "%s: flush failed", name);
+      const int res = decoder.feed(wire.substr(fed));
+      fed = wire.size();
+      CHECK(res == Z_OK, "%s window %zu: inflate returned %d after flush at %zu", name, window, res, pos);
+      CHECK(decoder.out.size() == pos && decoder.out == input.substr(0, pos),
+            "%s window %zu: %zu of %zu bytes decodable after flush", name, window, decoder.out.size(), pos);
+    }
+  }
+  CHECK(encoder.finish(), "%s: finish failed", name);
+  CHECK(encoder.get_bytes_in() == input.size() && encoder.get_bytes_out() == wire.size(),
+        "%s: counters %u in, %u out, expected %zu, %zu", name, encoder.get_bytes_in(), encoder.get_bytes_out(),
+        input.size(), wire.size());
+
+  // Z_STREAM_END also means that zlib verified the CRC and length in the trailer
+  const int res = decoder.feed(wire.substr(fed));
+  CHECK(res == Z_STREAM_END, "%s window %zu: inflate returned %d at the end", name, window, res);
+  CHECK(decoder.out == input, "%s window %zu: %zu bytes decoded, %zu written", name, window, decoder.out.size(),
+        input.size());
+}
+
+void check_round_trips() {
+  for (size_t window : WINDOWS) {
+    // Several times the window, so slide_() runs repeatedly
+    const size_t size = 5 * 2 * window + 123;
+    for (bool flushes : {false, true}) {
+      round_trip("text", make_text(size), window, 1460, flushes);
+      round_trip("runs", make_runs(size), window, 1460, flushes);
+      round_trip("random", make_random(size), window, 1460, flushes);
+      round_trip("small output", make_text(size), window, 7, flushes);
+    }
+    round_trip("empty", "", window, 64, false);
+    round_trip("one byte", "x", window, 64, true);
+  }
+}
+
+// Fixed Huffman codes only: incompressible data grows, but by a bounded amount
+void check_incompressible() {
+  const std::string input = make_random(64 * 1024);
+  for (size_t window : WINDOWS) {
+    GzipEncoder encoder(window, 1024);
+    size_t out = 0;
+    encoder.set_sink([&](const uint8_t *, size_t len) {
+      out += len;
+      return true;
+    });
+    encoder.init();
+    encoder.write(reinterpret_cast<const uint8_t *>(input.data()), input.size());
+    encoder.finish();
+    CHECK(out < input.size() * 113 / 100 + 32, "window %zu: %zu bytes from %zu", window, out, input.size());
+  }
+
+  const std::string text = make_text(64 * 1024);
+  GzipEncoder encoder(1024, 1024);
+  size_t out = 0;
+  encoder.set_sink([&](const uint8_t *, size_t len) {
+    out += len;
+    return true;
+  });
+  encoder.init();
+  encoder.write(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+  encoder.finish();
+  CHECK(out < text.size() * 40 / 100, "text compressed to %zu of %zu bytes", out, text.size());
+}
+
+void check_crc32() {
+  const std::string data = make_random(10000);
+  const auto *bytes = reinterpret_cast<const uint8_t *>(data.data());
+  CHECK(GzipEncoder::crc32(0, bytes, data.size()) == ::crc32(0, reinterpret_cast<const Bytef *>(bytes), data.size()),
+        "crc32 differs from zlib");
+  // Incremental use, as in write()
+  const uint32_t part = GzipEncoder::crc32(GzipEncoder::crc32(0, bytes, 3333), bytes + 3333, data.size() - 3333);
+  CHECK(part == GzipEncoder::crc32(0, bytes, data.size()), "incremental crc32 differs");
+}
+
+void check_init() {
+  for (size_t window : {0, 256, 1000, 3000, 16384}) {
+    GzipEncoder encoder(window, 64);
+    CHECK(!encoder.init(), "window %zu accepted", window);
+  }
+}
+
+// Once the sink fails, every further call reports it
+void check_sink_failure() {
+  GzipEncoder encoder(1024, 64);
+  int calls = 0;
+  encoder.set_sink([&](const uint8_t *, size_t) { return ++calls < 3; });
+  encoder.init();
+  const std::string input = make_random(4096);
+  CHECK(!encoder.write(reinterpret_cast<const uint8_t *>(input.data()), input.size()), "write ignored the sink");
+  const int failed_at = calls;
+  CHECK(!encoder.flush() && !encoder.finish(), "flush/finish ignored the sink");
+  CHECK(calls == failed_at, "sink called %d times after it failed", calls - failed_at);
+}
+
+}  // namespace
+
+int main() {
+  check_init();
+  check_crc32();
+  check_round_trips();
+  check_incompressible();
+  check_sink_failure();
+  return TEST_RESULT();
+}
@@ -0,0 +1,226 @@
+/**
+ * Host tests for SendPacer (send_pacer.h): backoff and jitter, the per-chunk deadline, and the
+ * throughput estimate behind chunk_size(), driven by a simulated congested socket.
+ */
+
+#include <cmath>
+#include <functional>
+
+#include "esphome/components/web_server_routes/send_pacer.h"
+#include "test_util.h"
+
+using esphome::web_server_routes::SendPacer;
+
+namespace {
+
+test_util::Rng rng;
+std::function<uint32_t()> random_source = [] { return rng.next(); };
+
+uint32_t expected_backoff(uint32_t attempt) {
+  uint32_t backoff = SendPacer::INITIAL_BACKOFF_MS;
+  for (uint32_t i = 0; i < attempt; i++)
+    backoff = std::min(backoff * 2, SendPacer::MAX_BACKOFF_MS);
+  return backoff;
+}
+
+// Every delay lies in [backoff / 2, backoff]; both ends are reachable
+void check_backoff() {
+  const std::function<uint32_t()> sources[] = {
+      [] { return 0u; },           // Smallest jitter
+      [] { return UINT32_MAX; },   // Largest remainder for most moduli
+      [] { return rng.next(); },
+  };
+  bool hit_low = false, hit_high = false;
+
+  for (const auto &source : sources) {
+    random_source = source;
+    for (int run = 0; run < 50; run++) {
+      SendPacer pacer;
+      pacer.set_deadline(100000);
+      pacer.begin(0);
+      for (uint32_t attempt = 0; attempt < 12; attempt++) {
+        uint32_t delay = 0;
+        CHECK(pacer.on_congested(0, delay), "attempt %u gave up before the deadline", attempt);
+        const uint32_t backoff = expected_backoff(attempt);
+        CHECK(delay >= backoff / 2 && delay <= backoff, "attempt %u: delay %u outside [%u, %u]", attempt, delay,
+              backoff / 2, backoff);
+        hit_low |= delay == backoff / 2 && attempt > 2;
+        hit_high |= delay == backoff && attempt > 2;
+      }
+      CHECK(pacer.get_retries() == 12 && pacer.get_stalls() == 1, "retries %u stalls %u", pacer.get_retries(),
+            pacer.get_stalls());
+
+      // A new chunk starts over with the initial backoff
+      pacer.begin(0);
+      uint32_t delay = 0;
+      pacer.on_congested(0, delay);
+      CHECK(delay <= SendPacer::INITIAL_BACKOFF_MS, "backoff not reset: %u", delay);
+      CHECK(pacer.get_stalls() == 2, "stalls %u", pacer.get_stalls());
+    }
+  }
+  CHECK(hit_low && hit_high, "jitter never reached its bounds (low %d, high %d)", hit_low, hit_high);
+  random_source = [] { return rng.next(); };
+}
+
+// A socket that never drains: the pacer gives up exactly at the deadline
+void check_deadline() {
+  for (uint32_t deadline : {0u, 1u, 40u, 500u, 2000u}) {
+    SendPacer pacer;
+    pacer.set_deadline(deadline);
+    const uint32_t start = 1000;
+    uint32_t now = start;
+    pacer.begin(now);
+
+    uint32_t delay = 0, attempts = 0;
+    while (pacer.on_congested(now, delay)) {
+      CHECK(delay > 0 || deadline == 0, "deadline %u: zero delay", deadline);
+      now += delay;
+      CHECK(now - start <= deadline, "deadline %u: waited until %u", deadline, now - start);
+      if (++attempts > 1000)
+        break;
+    }
+    CHECK(now - start == deadline || (deadline == 0 && now == start), "deadline %u: gave up after %u ms", deadline,
+          now - start);
+    CHECK(pacer.get_timeouts() == 1, "deadline %u: %u timeouts", deadline, pacer.get_timeouts());
+  }
+
+  // Time wraps around: the deadline is relative to begin()
+  SendPacer pacer;
+  pacer.set_deadline(100);
+  pacer.begin(UINT32_MAX - 10);
+  uint32_t delay = 0;
+  CHECK(pacer.on_congested(20, delay), "gave up across the millis() wrap");
+  CHECK(!pacer.on_congested(90, delay), "deadline ignored across the millis() wrap");
+}
+
+// chunk_size() follows the EWMA of the measured throughput
+void check_chunk_size() {
+  SendPacer pacer;
+  CHECK(pacer.chunk_size() == SendPacer::MAX_CHUNK, "chunk size without a measurement: %zu", pacer.chunk_size());
+
+  // First measurement seeds the estimate: 1000 bytes in 20 ms = 50 kB/s
+  pacer.on_sent(1000, 20000);
+  CHECK(pacer.get_throughput() == 50000, "seeded throughput %u", pacer.get_throughput());
+  CHECK(pacer.chunk_size() == 1000, "chunk size %zu at 50 kB/s", pacer.chunk_size());
+
+  // The link slows down to 30 kB/s: the estimate converges with weight 1/4
+  double model = 50000;
+  uint32_t previous = pacer.get_throughput();
+  for (int i = 0; i < 40; i++) {
+    pacer.on_sent(600, 20000);
+    model += (30000 - model) / 4;
+    CHECK(std::fabs(pacer.get_throughput() - model) <= 4, "step %d: throughput %u, EWMA %.0f", i,
+          pacer.get_throughput(), model);
+    CHECK(pacer.get_throughput() <= previous, "step %d: throughput rose on a slower link", i);
+    previous = pacer.get_throughput();
+    const size_t want = std::clamp<size_t>(size_t(uint64_t(pacer.get_throughput()) * SendPacer::TARGET_CHUNK_MS / 1000),
+                                           SendPacer::MIN_CHUNK, SendPacer::MAX_CHUNK);
+    CHECK(pacer.chunk_size() == want, "step %d: chunk size %zu, want %zu", i, pacer.chunk_size(), want);
+  }
+  CHECK(std::abs(int(pacer.chunk_size()) - 600) <= 2, "chunk size %zu at 30 kB/s", pacer.chunk_size());
+
+  // Limits: a crawling link keeps MIN_CHUNK, a fast one MAX_CHUNK, a zero duration does not divide by zero
+  for (int i = 0; i < 60; i++)
+    pacer.on_sent(10, 100000);
+  CHECK(pacer.chunk_size() == SendPacer::MIN_CHUNK, "chunk size %zu on a slow link", pacer.chunk_size());
+  for (int i = 0; i < 60; i++)
+    pacer.on_sent(8192, 0);
+  CHECK(pacer.chunk_size() == SendPacer::MAX_CHUNK, "chunk size %zu on a fast link", pacer.chunk_size());
+}
+
+/**
+ * A link with a given rate behind a send buffer, like an lwIP socket. A send blocks until the data
+ * fits into the buffer and fails after SEND_WAIT_MS (httpd reports ESP_ERR_HTTPD_RESP_SEND then).
+ * Every STALL_PERIOD_MS the link stops for STALL_MS, e.g. for Wi-Fi retransmissions.
+ */
+struct CongestedSocket {
+  static constexpr double SEND_WAIT_MS = 100;
+  static constexpr double STALL_PERIOD_MS = 500;
+  static constexpr double STALL_MS = 150;
+
+  uint32_t rate;    // Bytes per second
+  double capacity;  // Send buffer
+  double queued{0};
+  double now_ms{0};
+
+  bool stalled() const { return std::fmod(this->now_ms, STALL_PERIOD_MS) >= STALL_PERIOD_MS - STALL_MS; }
+
+  void wait(double ms) {
+    for (; ms > 0; ms -= 0.5) {
+      const double step = std::min(ms, 0.5);
+      if (!this->stalled())
+        this->queued = std::max(0.0, this->queued - this->rate * step / 1000);
+      this->now_ms += step;
+    }
+  }
+
+  bool send(size_t bytes, uint32_t &elapsed_us) {
+    const double start = this->now_ms;
+    while (this->queued + bytes > this->capacity + std::max(0.0, bytes - this->capacity)) {
+      if (this->now_ms - start >= SEND_WAIT_MS)
+        return false;
+      this->wait(0.5);
+    }
+    // Larger chunks than the buffer stream through it at the link rate
+    this->queued += std::min<double>(bytes, this->capacity);
+    this->wait(std::max(0.0, bytes - this->capacity) * 1000 / this->rate);
+    elapsed_us = uint32_t((this->now_ms - start) * 1000);
+    return true;
+  }
+};
+
+void check_congested_transfer(uint32_t rate) {
+  CongestedSocket socket{rate, 5744};  // TCP_SND_BUF of ESP-IDF (4 segments)
+  SendPacer pacer;
+  pacer.set_deadline(2000);
+
+  size_t remaining = 200000;
+  uint32_t chunks = 0;
+  while (remaining > 0) {
+    const size_t chunk = std::min(remaining, pacer.chunk_size());
+    CHECK(chunk >= std::min(remaining, SendPacer::MIN_CHUNK) && chunk <= SendPacer::MAX_CHUNK, "chunk of %zu bytes",
+          chunk);
+    pacer.begin(uint32_t(socket.now_ms));
+    uint32_t elapsed_us = 0;
+    bool sent = false;
+    while (!(sent = socket.send(chunk, elapsed_us))) {
+      uint32_t delay = 0;
+      if (!pacer.on_congested(uint32_t(socket.now_ms), delay))
+        break;
+      socket.wait(delay);
+    }
+    if (!sent)
+      break;
+    pacer.on_sent(chunk, elapsed_us);
+    remaining -= chunk;
+    chunks++;
+  }
+
+  CHECK(remaining == 0, "rate %u: %zu bytes not sent", rate, remaining);
+  CHECK(pacer.get_timeouts() == 0, "rate %u: %u timeouts", rate, pacer.get_timeouts());
+  CHECK(pacer.get_stalls() > 0, "rate %u: the socket never congested", rate);
+  // Once the buffer is full the estimate settles near the link rate, and the chunk size with it
+  const double error = std::fabs(double(pacer.get_throughput()) - rate) / rate;
+  CHECK(error < 0.25, "rate %u: estimated %u B/s", rate, pacer.get_throughput());
+  const double target = double(rate) * SendPacer::TARGET_CHUNK_MS / 1000;
+  CHECK(std::fabs(pacer.chunk_size() - target) < 0.25 * target, "rate %u: chunk size %zu", rate, pacer.chunk_size());
+  std::printf("rate %6u B/s: %u chunks, %u stalls, %u retries, estimate %u B/s, chunk size %zu, %.0f ms\n", rate,
+              chunks, pacer.get_stalls(), pacer.get_retries(), pacer.get_throughput(), pacer.chunk_size(),
+              socket.now_ms);
+}
+
+}  // namespace
+
+namespace esphome {
+uint32_t random_uint32() { return random_source(); }
+}  // namespace esphome
+
+int main() {
+  check_backoff();
+  check_deadline();
+  check_chunk_size();
+  for (uint32_t rate : {50000u, 100000u, 250000u})
+    check_congested_transfer(rate);
+
+  return TEST_RESULT();
+}
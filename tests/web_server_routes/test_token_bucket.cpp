@@ -0,0 +1,184 @@
+/**
+ * Host tests for TokenBucket (token_bucket.h): burst, refill, retry_after, refund(), the
+ * millis() wrap and concurrent use from several threads.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "esphome/components/web_server_routes/token_bucket.h"
+#include "test_util.h"
+
+using esphome::web_server_routes::TokenBucket;
+
+namespace {
+
+// Takes tokens at `now` until the bucket is empty; returns how many it gave
+int drain(TokenBucket &bucket, uint32_t now) {
+  uint32_t retry_after = 0;
+  int count = 0;
+  while (bucket.try_acquire(now, retry_after) && count < 100000)
+    count++;
+  return count;
+}
+
+void check_disabled() {
+  TokenBucket bucket;
+  uint32_t retry_after = 0;
+  for (int i = 0; i < 1000; i++)
+    CHECK(bucket.try_acquire(0, retry_after), "disabled bucket rejected request %d", i);
+  bucket.configure(0, 5);
+  CHECK(!bucket.is_enabled() && drain(bucket, 0) == 100000, "rate 0 does not admit everything");
+  bucket.refund();
+}
+
+// A full bucket admits `burst` requests at once, then the next one has to wait
+void check_burst() {
+  for (uint32_t burst : {1u, 2u, 5u, 20u}) {
+    TokenBucket bucket;
+    bucket.configure(2, burst);
+    const int count = drain(bucket, 1000);
+    CHECK(count == int(burst), "burst %u: %d requests admitted", burst, count);
+  }
+
+  // A burst of 0 still admits one request
+  TokenBucket bucket;
+  bucket.configure(2, 0);
+  CHECK(drain(bucket, 1000) == 1, "burst 0 does not admit a single request");
+}
+
+// Tokens come back at `rate` per second and never exceed the burst
+void check_refill() {
+  TokenBucket bucket;
+  bucket.configure(10, 5);  // One token per 100 ms
+  uint32_t now = 1000;
+  drain(bucket, now);
+
+  uint32_t retry_after = 0;
+  CHECK(!bucket.try_acquire(now + 99, retry_after), "token available after 99 ms");
+  CHECK(bucket.try_acquire(now + 100, retry_after), "no token after 100 ms");
+  now += 100;
+
+  const int refilled = drain(bucket, now + 350);
+  CHECK(refilled == 3, "3.5 tokens refilled, %d taken", refilled);
+  // The half token is kept: 50 ms later the next one is complete
+  CHECK(bucket.try_acquire(now + 400, retry_after), "partial token lost");
+
+  // A long pause fills the bucket only up to the burst
+  CHECK(drain(bucket, now + 100000) == 5, "bucket exceeded its burst after a pause");
+
+  // Fractional rates
+  TokenBucket slow;
+  slow.configure(0.5f, 1);
+  drain(slow, 0);
+  CHECK(!slow.try_acquire(1999, retry_after) && slow.try_acquire(2000, retry_after), "0.5/s does not refill in 2 s");
+}
+
+// retry_after is the exact time until the next token
+void check_retry_after() {
+  for (float rate : {0.5f, 1.0f, 3.0f, 10.0f, 100.0f}) {
+    TokenBucket bucket;
+    bucket.configure(rate, 2);
+    uint32_t now = 5000;
+    drain(bucket, now);
+
+    for (uint32_t wait : {0u, 1u, 7u}) {
+      uint32_t retry_after = 0;
+      CHECK(!bucket.try_acquire(now + wait, retry_after), "rate %.1f: token after %u ms", rate, wait);
+      if (retry_after > 1) {
+        uint32_t ignored = 0;
+        CHECK(!bucket.try_acquire(now + wait + retry_after - 1, ignored), "rate %.1f: token before retry_after %u",
+              rate, retry_after);
+      }
+      uint32_t again = 0;
+      CHECK(bucket.try_acquire(now + wait + retry_after, again), "rate %.1f: no token after retry_after %u ms", rate,
+            retry_after);
+      now += wait + retry_after;
+    }
+  }
+}
+
+void check_refund() {
+  TokenBucket bucket;
+  bucket.configure(1, 3);
+  uint32_t retry_after = 0;
+
+  // A refunded token can be taken again right away
+  CHECK(drain(bucket, 100) == 3, "burst not available");
+  bucket.refund();
+  CHECK(bucket.try_acquire(100, retry_after), "refunded token not available");
+  CHECK(!bucket.try_acquire(100, retry_after), "refund gave more than one token");
+
+  // Refunds do not grow the bucket beyond its burst
+  TokenBucket full;
+  full.configure(1, 3);
+  for (int i = 0; i < 10; i++)
+    full.refund();
+  CHECK(drain(full, 100) == 3, "refunds exceeded the burst");
+
+  // Refunding keeps the partial refill
+  TokenBucket partial;
+  partial.configure(10, 2);
+  drain(partial, 0);
+  partial.try_acquire(150, retry_after);  // 1.5 tokens refilled, 0.5 left
+  partial.refund();                       // 1.5
+  CHECK(drain(partial, 200) == 2, "partial token lost on refund");
+}
+
+// Tokens and time keep working when millis() wraps around
+void check_wrap() {
+  TokenBucket bucket;
+  bucket.configure(10, 2);
+  const uint32_t start = UINT32_MAX - 150;
+  drain(bucket, start);
+
+  uint32_t retry_after = 0;
+  CHECK(bucket.try_acquire(start + 100, retry_after), "no token before the wrap");
+  CHECK(!bucket.try_acquire(start + 199, retry_after), "token too early across the wrap");
+  CHECK(retry_after == 1, "retry_after %u across the wrap", retry_after);
+  CHECK(bucket.try_acquire(start + 200, retry_after), "no token after the wrap (now %u)", start + 200);
+  CHECK(drain(bucket, start + 100000) == 2, "burst wrong after the wrap");
+}
+
+// Lock-free: concurrent takers never get more than the bucket holds
+void check_concurrent() {
+  for (int run = 0; run < 20; run++) {
+    TokenBucket bucket;
+    bucket.configure(1, 1000);
+    std::atomic<int> admitted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&] {
+        uint32_t retry_after = 0;
+        for (int i = 0; i < 1000; i++) {
+          if (bucket.try_acquire(50, retry_after)) {
+            admitted++;
+            if (i % 4 == 0) {
+              bucket.refund();
+              admitted--;
+            }
+          }
+        }
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+    // Tokens refunded at the end are still in the bucket
+    const int left = drain(bucket, 50);
+    CHECK(admitted + left == 1000, "run %d: %d tokens handed out, %d left from 1000", run, admitted.load(), left);
+  }
+}
+
+}  // namespace
+
+int main() {
+  check_disabled();
+  check_burst();
+  check_refill();
+  check_retry_after();
+  check_refund();
+  check_wrap();
+  check_concurrent();
+  return TEST_RESULT();
+}